@@ -0,0 +1,54 @@
+#ifndef AVENIR_EXAMPLES_BENCHMARK_HPP
+#define AVENIR_EXAMPLES_BENCHMARK_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <limits>
+#include <string_view>
+#include <utility>
+
+namespace avenir::benchmark {
+
+// Results are folded into this so the optimiser cannot drop the work.
+inline volatile float g_sink = 0.0f;
+
+// Runs `function` `repetitions` times after one warm-up run, calling `setup`
+// untimed before each, and prints the fastest run in total milliseconds and
+// nanoseconds per item. Returns the fastest time in nanoseconds per item.
+template <typename Setup, typename Function>
+double measure(const std::string_view name, const std::size_t items,
+               const int repetitions, Setup &&setup, Function &&function) {
+    setup();
+    function();
+
+    double best = std::numeric_limits<double>::max();
+    for (int i = 0; i < repetitions; i++) {
+        setup();
+        const auto start = std::chrono::steady_clock::now();
+        function();
+        const auto end = std::chrono::steady_clock::now();
+        const std::chrono::duration<double, std::nano> elapsed = end - start;
+        best = std::min(best, elapsed.count());
+    }
+
+    const double perItem =
+        best / static_cast<double>(std::max<std::size_t>(items, 1));
+    std::printf("%-52.*s %8zu items %10.3f ms %8.2f ns/item\n",
+                static_cast<int>(name.size()), name.data(), items, best / 1e6,
+                perItem);
+
+    return perItem;
+}
+
+template <typename Function>
+double measure(const std::string_view name, const std::size_t items,
+               const int repetitions, Function &&function) {
+    return measure(name, items, repetitions, [] {},
+                   std::forward<Function>(function));
+}
+
+}  // namespace avenir::benchmark
+
+#endif  // AVENIR_EXAMPLES_BENCHMARK_HPP
@@ -0,0 +1,200 @@
+// Component access over 100k entities spread across 256 archetypes: the old
+// per-entity list of polymorphic components searched with dynamic_cast,
+// against dense component type ids (one mask test plus a column index) and
+// chunked iteration with Scene::each(). Also times query matching, where a
+// query's mask is tested against every archetype's signature.
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <random>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "Benchmark.hpp"
+#include "avenir/scene/Component.hpp"
+#include "avenir/scene/ComponentInfo.hpp"
+#include "avenir/scene/Scene.hpp"
+#include "avenir/scene/components/Transform.hpp"
+
+using namespace avenir;
+using namespace avenir::scene;
+
+namespace {
+
+constexpr std::size_t kEntityCount = 100'000;
+constexpr int kTagCount = 8;
+constexpr int kRepetitions = 10;
+constexpr int kQueryMatchRounds = 1000;
+
+template <int N>
+struct Tag final : public Component {
+    float value = 0.0f;
+
+    static constexpr std::string_view staticName = "Tag";
+};
+
+// The storage model dense ids replaced: each entity owns a list of
+// polymorphic components and lookups walk it with dynamic_cast.
+struct LegacyComponent {
+    virtual ~LegacyComponent() = default;
+};
+
+struct LegacyTransform final : public LegacyComponent {
+    components::Transform value;
+};
+
+template <int N>
+struct LegacyTag final : public LegacyComponent {
+    float value = 0.0f;
+};
+
+struct LegacyEntity {
+    std::vector<std::unique_ptr<LegacyComponent>> components;
+
+    template <typename T>
+    T *find() const {
+        for (const std::unique_ptr<LegacyComponent> &component : components) {
+            if (auto *result = dynamic_cast<T *>(component.get())) {
+                return result;
+            }
+        }
+
+        return nullptr;
+    }
+};
+
+template <int... Ns>
+void addTags(const unsigned tags, Entity entity, LegacyEntity &legacy,
+             std::integer_sequence<int, Ns...>) {
+    (
+        [&] {
+            if (tags & (1u << Ns)) {
+                entity.addComponent<Tag<Ns>>();
+                legacy.components.emplace_back(
+                    std::make_unique<LegacyTag<Ns>>());
+            }
+        }(),
+        ...);
+}
+
+}  // namespace
+
+int main() {
+    Scene scene;
+    std::vector<EntityId> ids;
+    std::vector<LegacyEntity> legacy(kEntityCount);
+
+    // Every entity holds a Transform and a random subset of the tags, which
+    // the legacy list stores ahead of the transform.
+    std::mt19937 random(1);
+    std::uniform_int_distribution<unsigned> tagSubset(0, (1u << kTagCount) - 1);
+    for (std::size_t i = 0; i < kEntityCount; i++) {
+        Entity entity = scene.createEntity();
+        entity.component<components::Transform>().position.x = float(i);
+        addTags(tagSubset(random), entity, legacy[i],
+                std::make_integer_sequence<int, kTagCount>());
+
+        auto transform = std::make_unique<LegacyTransform>();
+        transform->value.position.x = float(i);
+        legacy[i].components.emplace_back(std::move(transform));
+        ids.emplace_back(entity.id());
+    }
+
+    const Scene &constScene = scene;
+
+    benchmark::measure("dynamic_cast scan: find Transform", kEntityCount,
+                       kRepetitions, [&] {
+                           float sum = 0.0f;
+                           for (const LegacyEntity &entity : legacy) {
+                               sum += entity.find<LegacyTransform>()
+                                          ->value.position.x;
+                           }
+                           benchmark::g_sink = sum;
+                       });
+
+    benchmark::measure("dense id: Scene::component<Transform>", kEntityCount,
+                       kRepetitions, [&] {
+                           float sum = 0.0f;
+                           for (const EntityId id : ids) {
+                               sum += constScene
+                                          .component<components::Transform>(id)
+                                          .position.x;
+                           }
+                           benchmark::g_sink = sum;
+                       });
+
+    benchmark::measure("chunked: Scene::each<const Transform>", kEntityCount,
+                       kRepetitions, [&] {
+                           float sum = 0.0f;
+                           scene.each<const components::Transform>(
+                               [&](const components::Transform &transform) {
+                                   sum += transform.position.x;
+                               });
+                           benchmark::g_sink = sum;
+                       });
+
+    benchmark::measure("dynamic_cast scan: has Tag<5>", kEntityCount,
+                       kRepetitions, [&] {
+                           std::size_t count = 0;
+                           for (const LegacyEntity &entity : legacy) {
+                               count += entity.find<LegacyTag<5>>() != nullptr;
+                           }
+                           benchmark::g_sink = float(count);
+                       });
+
+    benchmark::measure("dense id: Scene::hasComponent<Tag<5>>", kEntityCount,
+                       kRepetitions, [&] {
+                           std::size_t count = 0;
+                           for (const EntityId id : ids) {
+                               count += scene.hasComponent<Tag<5>>(id);
+                           }
+                           benchmark::g_sink = float(count);
+                       });
+
+    // What a query does for each archetype when it first builds its cache:
+    // one AND of signature masks, against searching the archetype's
+    // component list for every queried type.
+    const std::vector<const ComponentInfo *> queried = {
+        &componentInfo<Tag<1>>(), &componentInfo<Tag<2>>(),
+        &componentInfo<Tag<6>>()};
+    ComponentMask queryMask;
+    for (const ComponentInfo *info : queried) {
+        queryMask.set(info->id);
+    }
+
+    const std::size_t matchCount =
+        scene.archetypes().size() * kQueryMatchRounds;
+    benchmark::measure(
+        "query matching: signature mask test", matchCount, kRepetitions, [&] {
+            std::size_t matches = 0;
+            for (int round = 0; round < kQueryMatchRounds; round++) {
+                for (const auto &archetype : scene.archetypes()) {
+                    matches +=
+                        (archetype->mask() & queryMask) == queryMask;
+                }
+            }
+            benchmark::g_sink = float(matches);
+        });
+
+    benchmark::measure(
+        "query matching: component list search", matchCount, kRepetitions,
+        [&] {
+            std::size_t matches = 0;
+            for (int round = 0; round < kQueryMatchRounds; round++) {
+                for (const auto &archetype : scene.archetypes()) {
+                    const std::vector<const ComponentInfo *> &components =
+                        archetype->components();
+                    matches += std::ranges::all_of(
+                        queried, [&](const ComponentInfo *info) {
+                            return std::ranges::find(components, info) !=
+                                   components.end();
+                        });
+                }
+            }
+            benchmark::g_sink = float(matches);
+        });
+
+    return 0;
+}
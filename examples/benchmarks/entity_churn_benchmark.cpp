@@ -0,0 +1,84 @@
+// Sustained spawn/despawn churn on a scene holding 100k live entities. Each
+// frame spawns a batch, parenting half of it under live entities, then
+// destroys the same number of the oldest entities, so destruction keeps
+// detaching children and recycling ids. Batches are destroyed one at a time
+// with destroyEntity() and together with destroyEntities(). Times are per
+// entity spawned and destroyed.
+
+#include <cstddef>
+#include <deque>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Benchmark.hpp"
+#include "avenir/scene/Scene.hpp"
+#include "avenir/scene/components/MeshRenderer.hpp"
+
+using namespace avenir;
+using namespace avenir::scene;
+
+namespace {
+
+constexpr std::size_t kLiveEntities = 100'000;
+constexpr int kFrames = 20;
+constexpr int kRepetitions = 5;
+
+void benchmarkChurn(const std::size_t batchSize, const bool batched) {
+    Scene scene;
+    std::deque<EntityId> live;
+    std::mt19937 random(1);
+
+    const auto spawn = [&](const std::size_t count) {
+        for (std::size_t i = 0; i < count; i++) {
+            Entity entity = scene.createEntity();
+            if (i % 4 == 0) {
+                entity.addComponent<components::MeshRenderer>();
+            }
+            if (i % 2 == 0 && !live.empty()) {
+                std::uniform_int_distribution<std::size_t> parent(
+                    0, live.size() - 1);
+                scene.setEntityParent(entity.id(), live[parent(random)]);
+            }
+            live.emplace_back(entity.id());
+        }
+    };
+
+    spawn(kLiveEntities);
+
+    std::vector<EntityId> doomed;
+    doomed.reserve(batchSize);
+    const auto frame = [&] {
+        spawn(batchSize);
+
+        doomed.assign(live.begin(), live.begin() + batchSize);
+        live.erase(live.begin(), live.begin() + batchSize);
+        if (batched) {
+            scene.destroyEntities(doomed);
+        } else {
+            for (const EntityId id : doomed) {
+                scene.destroyEntity(id);
+            }
+        }
+    };
+
+    benchmark::measure(
+        std::string(batched ? "destroyEntities" : "destroyEntity") +
+            " churn, " + std::to_string(batchSize) + " per frame",
+        batchSize * kFrames, kRepetitions, [&] {
+            for (int i = 0; i < kFrames; i++) {
+                frame();
+            }
+        });
+}
+
+}  // namespace
+
+int main() {
+    for (const std::size_t batchSize : {1'000u, 10'000u}) {
+        benchmarkChurn(batchSize, false);
+        benchmarkChurn(batchSize, true);
+    }
+
+    return 0;
+}
@@ -0,0 +1,166 @@
+// The spatial index and frustum culling over 100k MeshRenderer entities
+// scattered through a 1 km cube. Times updating the dynamic AABB tree after
+// 10% and all of the entities move, overlap, ray and frustum queries through
+// the tree, and culling throughput: FrustumCuller::cull() end to end and its
+// SIMD cullBounds() kernel against testing every AABB with
+// Frustum::intersects().
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "Benchmark.hpp"
+#include "avenir/scene/Bounds.hpp"
+#include "avenir/scene/FrustumCuller.hpp"
+#include "avenir/scene/Scene.hpp"
+#include "avenir/scene/components/Camera.hpp"
+#include "avenir/scene/components/MeshRenderer.hpp"
+#include "avenir/scene/components/Transform.hpp"
+
+using namespace avenir;
+using namespace avenir::scene;
+
+namespace {
+
+constexpr std::size_t kEntityCount = 100'000;
+constexpr float kWorldExtent = 500.0f;
+constexpr int kQueryCount = 1'000;
+constexpr int kRepetitions = 10;
+constexpr float kAspectRatio = 16.0f / 9.0f;
+
+}  // namespace
+
+int main() {
+    Scene scene;
+    std::mt19937 random(1);
+    std::uniform_real_distribution<float> coordinate(-kWorldExtent,
+                                                     kWorldExtent);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+    std::vector<EntityId> ids;
+    ids.reserve(kEntityCount);
+    for (std::size_t i = 0; i < kEntityCount; i++) {
+        Entity entity = scene.createEntity();
+        entity.component<components::Transform>().position = glm::vec3(
+            coordinate(random), coordinate(random), coordinate(random));
+        entity.addComponent<components::MeshRenderer>();
+        ids.emplace_back(entity.id());
+    }
+
+    // At the origin looking down -Z, seeing roughly a tenth of the scene.
+    Entity camera = scene.createEntity();
+    components::Camera &cameraComponent =
+        camera.addComponent<components::Camera>();
+    cameraComponent.fov = 60.0f;
+    cameraComponent.farPlane = kWorldExtent;
+    scene.updateSpatialIndex();
+
+    // Steps within the tree's fattening margin only refit the moved leaves;
+    // larger ones also remove and reinsert them.
+    int frame = 0;
+    const auto move = [&](const std::size_t stride, const float step) {
+        frame++;
+        for (std::size_t i = frame % stride; i < ids.size(); i += stride) {
+            scene.component<components::Transform>(ids[i]).position +=
+                glm::vec3(unit(random), unit(random), unit(random)) * step;
+        }
+    };
+
+    benchmark::measure(
+        "update index, 10% moving 2 cm", kEntityCount / 10, kRepetitions,
+        [&] { move(10, 0.02f); }, [&] { scene.updateSpatialIndex(); });
+    benchmark::measure(
+        "update index, all moving 2 cm", kEntityCount, kRepetitions,
+        [&] { move(1, 0.02f); }, [&] { scene.updateSpatialIndex(); });
+    benchmark::measure(
+        "update index, 10% moving 1 m (reinsert)", kEntityCount / 10,
+        kRepetitions, [&] { move(10, 1.0f); },
+        [&] { scene.updateSpatialIndex(); });
+
+    std::vector<Aabb> boxes;
+    std::vector<Ray> rays;
+    for (int i = 0; i < kQueryCount; i++) {
+        const glm::vec3 center(coordinate(random), coordinate(random),
+                               coordinate(random));
+        boxes.push_back({center - glm::vec3(10.0f), center + glm::vec3(10.0f)});
+        rays.push_back(
+            {center, glm::normalize(glm::vec3(unit(random), unit(random),
+                                              unit(random)) +
+                                    glm::vec3(0.0f, 0.0f, 1e-3f))});
+    }
+
+    benchmark::measure("queryOverlaps, 20 m boxes", kQueryCount, kRepetitions,
+                       [&] {
+                           std::size_t hits = 0;
+                           for (const Aabb &box : boxes) {
+                               scene.queryOverlaps(box,
+                                                   [&](EntityId) { hits++; });
+                           }
+                           benchmark::g_sink = float(hits);
+                       });
+
+    benchmark::measure("raycast, nearest hit", kQueryCount, kRepetitions, [&] {
+        float total = 0.0f;
+        for (const Ray &ray : rays) {
+            float nearest = 0.0f;
+            scene.raycast(ray, kWorldExtent,
+                          [&](EntityId, const float distance) {
+                              nearest = distance;
+                              return distance;
+                          });
+            total += nearest;
+        }
+        benchmark::g_sink = total;
+    });
+
+    FrustumCuller culler;
+    culler.cull(scene, camera.id(), kAspectRatio);
+    const Frustum frustum = culler.frustum();
+
+    benchmark::measure("queryFrustum through the tree", kEntityCount,
+                       kRepetitions, [&] {
+                           std::size_t visible = 0;
+                           scene.queryFrustum(frustum,
+                                              [&](EntityId) { visible++; });
+                           benchmark::g_sink = float(visible);
+                       });
+
+    benchmark::measure("FrustumCuller::cull (gather and cull)", kEntityCount,
+                       kRepetitions, [&] {
+                           culler.cull(scene, camera.id(), kAspectRatio);
+                           benchmark::g_sink =
+                               float(culler.visibleIndices().size());
+                       });
+
+    const CullingBoundsArrays bounds = culler.bounds();
+    std::vector<Aabb> aabbs;
+    for (std::size_t i = 0; i < bounds.centerX.size(); i++) {
+        const glm::vec3 center(bounds.centerX[i], bounds.centerY[i],
+                               bounds.centerZ[i]);
+        const glm::vec3 extent(bounds.extentX[i], bounds.extentY[i],
+                               bounds.extentZ[i]);
+        aabbs.push_back({center - extent, center + extent});
+    }
+
+    std::vector<uint32_t> visible(aabbs.size());
+    benchmark::measure("Frustum::intersects per AABB", aabbs.size(),
+                       kRepetitions, [&] {
+                           std::size_t count = 0;
+                           for (std::size_t i = 0; i < aabbs.size(); i++) {
+                               if (frustum.intersects(aabbs[i])) {
+                                   visible[count++] = static_cast<uint32_t>(i);
+                               }
+                           }
+                           benchmark::g_sink = float(count);
+                       });
+
+    benchmark::measure("FrustumCuller::cullBounds (SIMD)", aabbs.size(),
+                       kRepetitions, [&] {
+                           benchmark::g_sink = float(
+                               FrustumCuller::cullBounds(frustum, bounds,
+                                                         visible));
+                       });
+
+    return 0;
+}
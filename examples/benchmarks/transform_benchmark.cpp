@@ -0,0 +1,163 @@
+// Local matrix construction and the world transform pass at 10k, 100k and 1M
+// transforms: the glm translate * rotate * scale path against
+// Transform::localMatrix(), the batched Transform::localMatrices() kernels,
+// the closed-form Transform::inverseLocalMatrix() against glm::inverse(), and
+// Scene::updateWorldTransforms() over a flat scene with every entity, one
+// entity and 1% of the entities dirty.
+
+#include <cstddef>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include "Benchmark.hpp"
+#include "avenir/scene/Scene.hpp"
+#include "avenir/scene/components/Transform.hpp"
+
+using namespace avenir;
+using namespace avenir::scene;
+
+namespace {
+
+constexpr int kRepetitions = 10;
+
+std::vector<components::Transform> randomTransforms(const std::size_t count) {
+    std::mt19937 random(1);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    std::uniform_real_distribution<float> scale(0.5f, 2.0f);
+
+    std::vector<components::Transform> transforms;
+    transforms.reserve(count);
+    for (std::size_t i = 0; i < count; i++) {
+        transforms.emplace_back(
+            glm::vec3(unit(random), unit(random), unit(random)) * 100.0f,
+            glm::normalize(glm::quat(unit(random), unit(random), unit(random),
+                                     unit(random))),
+            glm::vec3(scale(random), scale(random), scale(random)));
+    }
+
+    return transforms;
+}
+
+void benchmarkLocalMatrices(const std::size_t count) {
+    const std::vector<components::Transform> transforms =
+        randomTransforms(count);
+    std::vector<glm::mat4> matrices(count);
+
+    std::vector<float> streams[10];
+    for (const components::Transform &t : transforms) {
+        const float values[10] = {t.position.x, t.position.y, t.position.z,
+                                  t.rotation.x, t.rotation.y, t.rotation.z,
+                                  t.rotation.w, t.scale.x,    t.scale.y,
+                                  t.scale.z};
+        for (int stream = 0; stream < 10; stream++) {
+            streams[stream].emplace_back(values[stream]);
+        }
+    }
+
+    const std::string suffix = " (" + std::to_string(count) + ")";
+
+    benchmark::measure("glm translate * rotate * scale" + suffix, count,
+                       kRepetitions, [&] {
+                           for (std::size_t i = 0; i < count; i++) {
+                               const components::Transform &t = transforms[i];
+                               matrices[i] =
+                                   glm::translate(glm::mat4(1.0f), t.position) *
+                                   glm::mat4_cast(t.rotation) *
+                                   glm::scale(glm::mat4(1.0f), t.scale);
+                           }
+                           benchmark::g_sink = matrices[count / 2][3][0];
+                       });
+
+    benchmark::measure("Transform::localMatrix" + suffix, count,
+                       kRepetitions, [&] {
+                           for (std::size_t i = 0; i < count; i++) {
+                               matrices[i] = transforms[i].localMatrix();
+                           }
+                           benchmark::g_sink = matrices[count / 2][3][0];
+                       });
+
+    benchmark::measure(
+        "Transform::localMatrices (SoA)" + suffix, count, kRepetitions, [&] {
+            components::Transform::localMatrices(
+                {streams[0], streams[1], streams[2], streams[3], streams[4],
+                 streams[5], streams[6], streams[7], streams[8], streams[9]},
+                matrices);
+            benchmark::g_sink = matrices[count / 2][3][0];
+        });
+}
+
+void benchmarkInverseLocalMatrices(const std::size_t count) {
+    const std::vector<components::Transform> transforms =
+        randomTransforms(count);
+    std::vector<glm::mat4> matrices(count);
+    const std::string suffix = " (" + std::to_string(count) + ")";
+
+    benchmark::measure("glm::inverse(localMatrix())" + suffix, count,
+                       kRepetitions, [&] {
+                           for (std::size_t i = 0; i < count; i++) {
+                               matrices[i] =
+                                   glm::inverse(transforms[i].localMatrix());
+                           }
+                           benchmark::g_sink = matrices[count / 2][3][0];
+                       });
+
+    benchmark::measure("Transform::inverseLocalMatrix" + suffix, count,
+                       kRepetitions, [&] {
+                           for (std::size_t i = 0; i < count; i++) {
+                               matrices[i] = transforms[i].inverseLocalMatrix();
+                           }
+                           benchmark::g_sink = matrices[count / 2][3][0];
+                       });
+}
+
+void benchmarkWorldTransforms(const std::size_t count) {
+    Scene scene;
+    std::vector<EntityId> ids;
+    ids.reserve(count);
+    for (const components::Transform &transform : randomTransforms(count)) {
+        Entity entity = scene.createEntity();
+        entity.component<components::Transform>() = transform;
+        ids.emplace_back(entity.id());
+    }
+
+    benchmark::measure(
+        "Scene::updateWorldTransforms (all dirty) (" + std::to_string(count) +
+            ")",
+        count, kRepetitions,
+        [&] {
+            for (const EntityId id : ids) {
+                scene.markTransformDirty(id);
+            }
+        },
+        [&] { scene.updateWorldTransforms(); });
+
+    // A few moved entities should cost in proportion to what moved.
+    for (const std::size_t dirty : {std::size_t(1), count / 100}) {
+        benchmark::measure(
+            "Scene::updateWorldTransforms (" + std::to_string(dirty) +
+                " dirty) (" + std::to_string(count) + ")",
+            dirty, kRepetitions,
+            [&] {
+                for (std::size_t i = 0; i < dirty; i++) {
+                    scene.markTransformDirty(ids[i * (count / dirty)]);
+                }
+            },
+            [&] { scene.updateWorldTransforms(); });
+    }
+}
+
+}  // namespace
+
+int main() {
+    for (const std::size_t count : {10'000u, 100'000u, 1'000'000u}) {
+        benchmarkLocalMatrices(count);
+        benchmarkInverseLocalMatrices(count);
+        benchmarkWorldTransforms(count);
+    }
+
+    return 0;
+}
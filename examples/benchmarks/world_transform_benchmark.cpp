@@ -0,0 +1,84 @@
+// Scene::updateWorldTransforms() at 100k and 1M entities on 1, 2, 4 and
+// all hardware threads. The calling thread takes part in every pass, so N
+// threads means a job system with N - 1 workers.
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Benchmark.hpp"
+#include "avenir/jobs/JobSystem.hpp"
+#include "avenir/scene/Scene.hpp"
+#include "avenir/scene/components/Transform.hpp"
+
+using namespace avenir;
+using namespace avenir::scene;
+
+namespace {
+
+constexpr int kRepetitions = 10;
+
+// One root per eight entities; every other entity hangs off a random earlier
+// one, giving a hierarchy a handful of levels deep.
+void benchmarkWorldTransforms(const std::size_t count,
+                              const uint32_t threads) {
+    jobs::JobSystem jobSystem(threads - 1);
+    Scene scene(jobSystem);
+
+    std::mt19937 random(1);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    std::vector<EntityId> roots;
+    std::vector<EntityId> ids;
+    ids.reserve(count);
+    for (std::size_t i = 0; i < count; i++) {
+        Entity entity = scene.createEntity();
+        components::Transform &transform =
+            entity.component<components::Transform>();
+        transform.position =
+            glm::vec3(unit(random), unit(random), unit(random));
+        transform.rotation = glm::normalize(
+            glm::quat(unit(random), unit(random), unit(random), unit(random)));
+
+        if (i % 8 == 0) {
+            roots.emplace_back(entity.id());
+        } else {
+            std::uniform_int_distribution<std::size_t> parent(0, i - 1);
+            scene.setEntityParent(entity.id(), ids[parent(random)]);
+        }
+        ids.emplace_back(entity.id());
+    }
+
+    benchmark::measure(
+        "updateWorldTransforms " + std::to_string(count) +
+            " entities, threads=" + std::to_string(threads),
+        count, kRepetitions,
+        [&] {
+            for (const EntityId root : roots) {
+                scene.markTransformDirty(root);
+            }
+        },
+        [&] { scene.updateWorldTransforms(); });
+}
+
+}  // namespace
+
+int main() {
+    const uint32_t hardwareThreads =
+        std::max(1u, std::thread::hardware_concurrency());
+    std::vector<uint32_t> threadCounts = {1, 2, 4};
+    if (hardwareThreads > 4) {
+        threadCounts.emplace_back(hardwareThreads);
+    }
+
+    for (const std::size_t count : {100'000u, 1'000'000u}) {
+        for (const uint32_t threads : threadCounts) {
+            benchmarkWorldTransforms(count, threads);
+        }
+    }
+
+    return 0;
+}
@@ -5,14 +5,12 @@
 #include <glm/gtc/quaternion.hpp>
 #include <avenir/avenir.hpp>
 
-FPSController::FPSController(avenir::Entity &player, avenir::Scene &scene,
+FPSController::FPSController(avenir::Entity player, avenir::Scene &scene,
                              avenir::InputManager &inputManager)
     : m_player(player), m_scene(scene), m_inputManager(inputManager) {
-    avenir::Entity &playerCamera =
-        *findChildEntityWithCameraComponent().value();
-    checkIfCameraEntityIsPrimary(playerCamera);
+    m_camera = findChildEntityWithCameraComponent().value();
+    checkIfCameraEntityIsPrimary(m_camera);
 
-    m_camera = &playerCamera;
     m_inputManager.setCursorMode(avenir::CursorMode::eDisabled);
 }
 
@@ -21,18 +19,17 @@ void FPSController::update(const float deltaTime) {
     handleMousePosition();
 }
 
-std::optional<avenir::Entity *>
+std::optional<avenir::Entity>
 FPSController::findChildEntityWithCameraComponent() const {
-    uint32_t playerCameraEntityId = 0;
-    for (const uint32_t child : m_player.children()) {
-        const avenir::Entity &childEntity =
-            *m_scene.findEntityById(child).value();
-        if (childEntity.hasComponent<avenir::Camera>()) {
-            playerCameraEntityId = childEntity.id();
-        }
-    }
-
-    return m_scene.findEntityById(playerCameraEntityId);
+    std::optional<avenir::Entity> playerCamera;
+    m_scene.each<const avenir::Camera>(
+        [&](const avenir::Entity entity, const avenir::Camera &) {
+            if (entity.parent() == m_player.id()) {
+                playerCamera = entity;
+            }
+        });
+
+    return playerCamera;
 }
 
 void FPSController::checkIfCameraEntityIsPrimary(
@@ -44,7 +41,7 @@ void FPSController::checkIfCameraEntityIsPrimary(
     }
 }
 
-void FPSController::handleKeyboardInput(const float deltaTime) const {
+void FPSController::handleKeyboardInput(const float deltaTime) {
     auto &playerTransform = m_player.component<avenir::Transform>();
 
     const float velocity = m_movementSpeed * deltaTime;
@@ -83,7 +80,7 @@ void FPSController::handleKeyboardInput(const float deltaTime) const {
 }
 
 void FPSController::handleMousePosition() {
-    auto &cameraTransform = m_camera->component<avenir::Transform>();
+    auto &cameraTransform = m_camera.component<avenir::Transform>();
     auto &playerTransform = m_player.component<avenir::Transform>();
 
     const glm::vec2 mouseOffsets = m_inputManager.mouseDeltas();
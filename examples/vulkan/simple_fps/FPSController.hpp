@@ -5,24 +5,24 @@
 
 class FPSController {
 public:
-    FPSController(avenir::Entity &player, avenir::Scene &scene,
+    FPSController(avenir::Entity player, avenir::Scene &scene,
                   avenir::InputManager &inputManager);
     ~FPSController() = default;
 
     void update(float deltaTime);
 
 private:
-    [[nodiscard]] std::optional<avenir::Entity *>
+    [[nodiscard]] std::optional<avenir::Entity>
     findChildEntityWithCameraComponent() const;
 
     static void checkIfCameraEntityIsPrimary(
         const avenir::Entity &cameraEntity);
 
-    void handleKeyboardInput(float deltaTime) const;
+    void handleKeyboardInput(float deltaTime);
     void handleMousePosition();
 
-    avenir::Entity &m_player;
-    avenir::Entity *m_camera;
+    avenir::Entity m_player;
+    avenir::Entity m_camera;
 
     avenir::Scene &m_scene;
 
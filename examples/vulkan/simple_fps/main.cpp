@@ -12,25 +12,42 @@ int main(int argc, char *argv[]) {
 
     avenir::Scene scene;
 
-    avenir::Entity &player = scene.createEntity();
+    avenir::Entity player = scene.createEntity();
     player.component<avenir::Transform>().position =
         glm::vec3(0.0f, 0.0f, 2.0f);
 
-    avenir::Entity &camera = scene.createEntity();
+    avenir::Entity camera = scene.createEntity();
     camera.component<avenir::Transform>().position =
         glm::vec3(0.0f, 0.8f, 0.0f);
     camera.addComponent<avenir::Camera>();
 
     scene.setEntityParent(camera.id(), player.id());
 
+    const avenir::Mesh cubeMesh = avenir::Mesh::cube();
+    avenir::Entity cube = scene.createEntity();
+    auto &cubeRenderer = cube.addComponent<avenir::MeshRenderer>();
+    cubeRenderer.mesh = renderer->addMesh(cubeMesh);
+    cubeRenderer.localBounds = cubeMesh.bounds();
+
     FPSController fpsController(player, scene, inputManager);
+
+    avenir::SystemScheduler scheduler(scene);
+    scheduler
+        .addSystem("FPSController",
+                   [&](const avenir::SystemContext &context) {
+                       fpsController.update(context.deltaTime);
+                   })
+        .reads<avenir::Camera>()
+        .writes<avenir::Transform>()
+        .runOnMainThread();
+
     while (window.isOpen()) {
         time.tick();
         avenir::Window::pollEvents();
 
-        fpsController.update(time.deltaTime());
+        scheduler.run(time.deltaTime());
 
-        renderer->drawFrame(scene.entityInverseWorldMatrix(camera.id()));
+        renderer->drawFrame(scene);
     }
 
     return 0;
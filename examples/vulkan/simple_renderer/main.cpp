@@ -7,14 +7,20 @@ int main(int argc, char *argv[]) {
 
     avenir::Scene scene;
 
-    avenir::Entity &camera = scene.createEntity();
+    avenir::Entity camera = scene.createEntity();
     camera.component<avenir::Transform>().position =
         glm::vec3(0.0f, 0.0f, 2.0f);
     camera.addComponent<avenir::Camera>();
 
+    const avenir::Mesh cubeMesh = avenir::Mesh::cube();
+    avenir::Entity cube = scene.createEntity();
+    auto &cubeRenderer = cube.addComponent<avenir::MeshRenderer>();
+    cubeRenderer.mesh = renderer->addMesh(cubeMesh);
+    cubeRenderer.localBounds = cubeMesh.bounds();
+
     while (window.isOpen()) {
         avenir::platform::Window::pollEvents();
-        renderer->drawFrame(scene.entityInverseWorldMatrix(camera.id()));
+        renderer->drawFrame(scene);
     }
 
     return 0;
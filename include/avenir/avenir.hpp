@@ -4,14 +4,24 @@
 #include "avenir/platform/Time.hpp"
 #include "avenir/platform/Window.hpp"
 #include "avenir/input/InputManager.hpp"
+#include "avenir/jobs/JobSystem.hpp"
+#include "avenir/graphics/Mesh.hpp"
+#include "avenir/graphics/MeshHandle.hpp"
 #include "avenir/graphics/Renderer.hpp"
+#include "avenir/scene/Bounds.hpp"
+#include "avenir/scene/FrustumCuller.hpp"
 #include "avenir/scene/Entity.hpp"
 #include "avenir/scene/components/Camera.hpp"
 #include "avenir/scene/components/MeshRenderer.hpp"
 #include "avenir/scene/components/Transform.hpp"
+#include "avenir/scene/components/WorldTransform.hpp"
+#include "avenir/scene/ComponentRegistry.hpp"
 #include "avenir/scene/Scene.hpp"
+#include "avenir/scene/SceneCommandBuffer.hpp"
+#include "avenir/scene/SceneSnapshot.hpp"
+#include "avenir/scene/SystemScheduler.hpp"
+#include "avenir/scene/View.hpp"
 #include "avenir/debug/Debug.hpp"
-#include "avenir/graphics/Mesh.hpp"
 
 namespace avenir {
 
@@ -22,13 +32,31 @@ using InputManager = input::InputManager;
 using Key = input::Key;
 using CursorMode = input::CursorMode;
 
+using JobSystem = jobs::JobSystem;
+using JobCounter = jobs::Counter;
+
 using Renderer = graphics::Renderer;
 using GraphicsApi = graphics::Api;
+using Mesh = graphics::Mesh;
+using MeshHandle = graphics::MeshHandle;
 
 using Scene = scene::Scene;
 using Entity = scene::Entity;
+using EntityId = scene::EntityId;
+using ComponentRegistry = scene::ComponentRegistry;
+using SceneCommandBuffer = scene::SceneCommandBuffer;
+using SceneSnapshot = scene::SceneSnapshot;
+using System = scene::System;
+using SystemContext = scene::SystemContext;
+using SystemScheduler = scene::SystemScheduler;
+
+using Aabb = scene::Aabb;
+using Ray = scene::Ray;
+using Frustum = scene::Frustum;
+using FrustumCuller = scene::FrustumCuller;
 
 using Transform = scene::components::Transform;
+using WorldTransform = scene::components::WorldTransform;
 using Camera = scene::components::Camera;
 using MeshRenderer = scene::components::MeshRenderer;
 
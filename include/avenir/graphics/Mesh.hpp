@@ -1,8 +1,13 @@
 #ifndef AVENIR_MESH_HPP
 #define AVENIR_MESH_HPP
 
+#include <cstdint>
+#include <vector>
+
 #include <glm/glm.hpp>
 
+#include "avenir/scene/Bounds.hpp"
+
 namespace avenir::graphics {
 struct Vertex {
     glm::vec3 position;
@@ -10,17 +15,29 @@ struct Vertex {
     glm::vec2 textureCoordinates;
 };
 
+/*
+ * CPU-side indexed triangle list. Renderers upload a copy of it through
+ * Renderer::addMesh(), so a Mesh can be discarded once added.
+ */
 class Mesh {
 public:
+    Mesh() = default;
+    Mesh(std::vector<Vertex> vertices, std::vector<uint16_t> indices);
     virtual ~Mesh() = default;
 
-protected:
-    [[nodiscard]] std::vector<Vertex> vertices() const;
-    [[nodiscard]] std::vector<uint16_t> indices() const;
+    // Unit cube centred on the origin.
+    static Mesh cube();
+
+    [[nodiscard]] const std::vector<Vertex> &vertices() const;
+    [[nodiscard]] const std::vector<uint16_t> &indices() const;
+
+    // Bounds of every vertex position, e.g. for MeshRenderer::localBounds.
+    [[nodiscard]] scene::Aabb bounds() const;
 
     void setVertices(const std::vector<Vertex> &vertices);
     void setIndices(const std::vector<uint16_t> &indices);
 
+protected:
     std::vector<Vertex> m_vertices;
     std::vector<uint16_t> m_indices;
 };
@@ -0,0 +1,25 @@
+#ifndef AVENIR_GRAPHICS_MESHHANDLE_HPP
+#define AVENIR_GRAPHICS_MESHHANDLE_HPP
+
+#include <compare>
+#include <cstdint>
+
+namespace avenir::graphics {
+
+/*
+ * Generational handle to a mesh uploaded to a renderer. A default-constructed
+ * handle refers to no mesh; a handle whose mesh was removed fails validation
+ * even after its slot is reused.
+ */
+struct MeshHandle {
+    static constexpr uint32_t kInvalidIndex = UINT32_MAX;
+
+    uint32_t index = kInvalidIndex;
+    uint32_t generation = 0;
+
+    auto operator<=>(const MeshHandle &) const = default;
+};
+
+}  // namespace avenir::graphics
+
+#endif  // AVENIR_GRAPHICS_MESHHANDLE_HPP
@@ -0,0 +1,75 @@
+#ifndef AVENIR_GRAPHICS_MESHREGISTRY_HPP
+#define AVENIR_GRAPHICS_MESHREGISTRY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "avenir/graphics/MeshHandle.hpp"
+#include "avenir/graphics/RangeAllocator.hpp"
+
+namespace avenir::graphics {
+
+class Mesh;
+
+// Where a mesh lives inside the shared vertex and index buffers, in elements.
+// Indices are relative to firstVertex, which is passed as the vertex offset
+// of the draw.
+struct MeshRange {
+    uint32_t firstVertex = 0;
+    uint32_t vertexCount = 0;
+    uint32_t firstIndex = 0;
+    uint32_t indexCount = 0;
+};
+
+/*
+ * Book-keeping for packing many meshes into one vertex buffer and one index
+ * buffer, independent of the graphics API. The registry only decides where
+ * each mesh goes; the renderer owns the buffers, copies the data in, and
+ * resizes them to vertexCapacity() and indexCapacity() whenever add() grows
+ * those.
+ */
+class MeshRegistry {
+public:
+    MeshRegistry(uint32_t vertexCapacity, uint32_t indexCapacity);
+
+    // Reserves space for `mesh`, doubling the capacities if it does not fit.
+    // Throws if the mesh has no vertices or indices.
+    MeshHandle add(const Mesh &mesh);
+
+    // Invalidates `handle` and returns its range. The range stays reserved
+    // until passed to release(), so it can be kept until the GPU no longer
+    // reads it. Throws if `handle` is not valid.
+    MeshRange remove(MeshHandle handle);
+    void release(const MeshRange &range);
+
+    [[nodiscard]] bool isValid(MeshHandle handle) const;
+    // Throws if `handle` is not valid.
+    [[nodiscard]] const MeshRange &range(MeshHandle handle) const;
+
+    [[nodiscard]] uint32_t vertexCapacity() const;
+    [[nodiscard]] uint32_t indexCapacity() const;
+    [[nodiscard]] std::size_t size() const;
+    // Every handle index, valid or not, is below this.
+    [[nodiscard]] uint32_t slotCount() const;
+
+private:
+    struct Slot {
+        MeshRange range;
+        uint32_t generation = 0;
+        bool alive = false;
+    };
+
+    static uint32_t allocate(RangeAllocator &allocator, uint32_t count);
+
+    std::vector<Slot> m_slots;
+    std::vector<uint32_t> m_freeSlots;
+    std::size_t m_size = 0;
+
+    RangeAllocator m_vertices;
+    RangeAllocator m_indices;
+};
+
+}  // namespace avenir::graphics
+
+#endif  // AVENIR_GRAPHICS_MESHREGISTRY_HPP
@@ -0,0 +1,57 @@
+#ifndef AVENIR_GRAPHICS_RANGEALLOCATOR_HPP
+#define AVENIR_GRAPHICS_RANGEALLOCATOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <set>
+#include <utility>
+
+namespace avenir::graphics {
+
+/*
+ * Hands out sub-ranges of a linear space [0, capacity) such as a GPU buffer
+ * or a block of device memory. Only offsets are tracked; the memory itself
+ * lives elsewhere. Free ranges are indexed both by offset, so freed ranges
+ * merge with their free neighbours, and by size, so allocation takes the
+ * smallest free range that fits in O(log n).
+ */
+class RangeAllocator {
+public:
+    explicit RangeAllocator(uint64_t capacity = 0);
+
+    // Returns the offset of `size` units aligned to `alignment` (a power of
+    // two), or nothing if no free range is large enough.
+    [[nodiscard]] std::optional<uint64_t> allocate(uint64_t size,
+                                                   uint64_t alignment = 1);
+    // `offset` and `size` must be exactly those of an earlier allocation.
+    void free(uint64_t offset, uint64_t size);
+
+    // Extends the space to `capacity`, which must not be smaller than the
+    // current one. Existing allocations keep their offsets.
+    void grow(uint64_t capacity);
+
+    [[nodiscard]] uint64_t capacity() const;
+    [[nodiscard]] uint64_t used() const;
+    [[nodiscard]] bool empty() const;
+
+    // Free space is fragmented when it is split over many ranges, none of
+    // them close to the total.
+    [[nodiscard]] std::size_t freeRangeCount() const;
+    [[nodiscard]] uint64_t largestFreeRange() const;
+
+private:
+    void insertFreeRange(uint64_t offset, uint64_t size);
+    void eraseFreeRange(std::map<uint64_t, uint64_t>::iterator range);
+
+    // Free ranges keyed by offset, and the same ranges as (size, offset).
+    std::map<uint64_t, uint64_t> m_freeRanges;
+    std::set<std::pair<uint64_t, uint64_t>> m_freeSizes;
+    uint64_t m_capacity = 0;
+    uint64_t m_used = 0;
+};
+
+}  // namespace avenir::graphics
+
+#endif  // AVENIR_GRAPHICS_RANGEALLOCATOR_HPP
@@ -6,22 +6,37 @@
 #include <GLFW/glfw3.h>
 #include <glm/glm.hpp>
 
+#include "avenir/graphics/MeshHandle.hpp"
+
 namespace avenir::platform {
 class Window;
 }
 
+namespace avenir::scene {
+class Scene;
+}
+
 namespace avenir::graphics {
 
 enum class Api { eVulkan = 0 };
 
+class Mesh;
+
 class Renderer {
 public:
     static std::unique_ptr<Renderer> create(platform::Window &window, Api api);
     virtual ~Renderer() = default;
 
-    virtual void drawFrame(glm::mat4 cameraViewMatrix) = 0;
+    // Renders the scene's MeshRenderer entities through its primary camera.
+    virtual void drawFrame(scene::Scene &scene) = 0;
     virtual void onFramebufferResize(int width, int height) = 0;
 
+    // Uploads a copy of `mesh` for MeshRenderer components to reference.
+    virtual MeshHandle addMesh(const Mesh &mesh) = 0;
+    // Invalidates `mesh` at once; its GPU storage is reused once no frame in
+    // flight still reads it. Throws if `mesh` is not valid.
+    virtual void removeMesh(MeshHandle mesh) = 0;
+
     static void framebufferResizeCallback(GLFWwindow *window, int width,
                                           int height);
 };
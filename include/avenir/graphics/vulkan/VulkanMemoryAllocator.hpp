@@ -0,0 +1,180 @@
+#ifndef AVENIR_GRAPHICS_VULKAN_VULKANMEMORYALLOCATOR_HPP
+#define AVENIR_GRAPHICS_VULKAN_VULKANMEMORYALLOCATOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include "avenir/graphics/RangeAllocator.hpp"
+
+namespace avenir::graphics::vulkan {
+
+class VulkanMemoryAllocator;
+
+enum class VulkanResourceKind {
+    // Buffers and linear-tiling images.
+    eLinear = 0,
+    // Optimal-tiling images, kept apart from linear resources by
+    // bufferImageGranularity.
+    eOptimalImage = 1,
+    // Short-lived linear resources such as staging buffers, bump-allocated
+    // from pages that are recycled as soon as all of their resources are
+    // freed.
+    eTransient = 2
+};
+
+/*
+ * A range of device memory owned by a VulkanMemoryAllocator, returned to it
+ * on destruction like a vk::raii::DeviceMemory. Host-visible memory is
+ * persistently mapped, so mapped() can be written at any time.
+ */
+class VulkanAllocation {
+public:
+    VulkanAllocation() = default;
+    VulkanAllocation(std::nullptr_t) {}
+    ~VulkanAllocation();
+
+    VulkanAllocation(const VulkanAllocation &) = delete;
+    VulkanAllocation &operator=(const VulkanAllocation &) = delete;
+    VulkanAllocation(VulkanAllocation &&other) noexcept;
+    VulkanAllocation &operator=(VulkanAllocation &&other) noexcept;
+
+    [[nodiscard]] vk::DeviceMemory memory() const;
+    [[nodiscard]] vk::DeviceSize offset() const;
+    [[nodiscard]] vk::DeviceSize size() const;
+    // Null unless the memory is host-visible.
+    [[nodiscard]] void *mapped() const;
+
+private:
+    friend class VulkanMemoryAllocator;
+
+    void release();
+
+    VulkanMemoryAllocator *m_allocator = nullptr;
+    vk::DeviceMemory m_memory = nullptr;
+    vk::DeviceSize m_offset = 0;
+    vk::DeviceSize m_size = 0;
+    void *m_mapped = nullptr;
+    // Pool and block index, or the index of the dedicated memory and
+    // VulkanMemoryAllocator::kDedicated.
+    uint32_t m_pool = 0;
+    uint32_t m_block = 0;
+};
+
+// Counters across every memory type, for spotting leaks, allocation-count
+// pressure and fragmentation.
+struct VulkanMemoryStatistics {
+    // vkAllocateMemory calls alive, to compare with maxMemoryAllocationCount.
+    uint32_t deviceMemoryCount = 0;
+    uint32_t dedicatedAllocationCount = 0;
+    uint32_t allocationCount = 0;
+    vk::DeviceSize reservedBytes = 0;
+    vk::DeviceSize usedBytes = 0;
+    // Free space in block pools, split into this many ranges; the largest
+    // range is how much of it one allocation can still use.
+    uint32_t freeRangeCount = 0;
+    vk::DeviceSize largestFreeRange = 0;
+
+    // 0 when all free block space is contiguous, approaching 1 as it splits
+    // into slivers.
+    [[nodiscard]] float fragmentation() const;
+};
+
+/*
+ * Suballocates buffers and images out of large vk::DeviceMemory blocks
+ * instead of one vkAllocateMemory per resource, which is slow and limited to
+ * maxMemoryAllocationCount allocations.
+ *
+ * Each memory type has its own pools of blocks. Long-lived resources are
+ * placed by best fit with neighbouring free ranges merged on free; transient
+ * ones are bump-allocated from linear pages. Resources larger than half a
+ * block get dedicated memory. When bufferImageGranularity is above one,
+ * optimal-tiling images use separate blocks from linear resources so the two
+ * never alias within a granularity page.
+ *
+ * Not thread-safe.
+ */
+class VulkanMemoryAllocator {
+public:
+    VulkanMemoryAllocator(const vk::raii::PhysicalDevice &physicalDevice,
+                          const vk::raii::Device &logicalDevice);
+    ~VulkanMemoryAllocator();
+
+    VulkanMemoryAllocator(const VulkanMemoryAllocator &) = delete;
+    VulkanMemoryAllocator &operator=(const VulkanMemoryAllocator &) = delete;
+    VulkanMemoryAllocator(VulkanMemoryAllocator &&) = delete;
+    VulkanMemoryAllocator &operator=(VulkanMemoryAllocator &&) = delete;
+
+    // Throws if no memory type matches or device memory runs out.
+    [[nodiscard]] VulkanAllocation allocate(
+        const vk::MemoryRequirements &requirements,
+        vk::MemoryPropertyFlags properties, VulkanResourceKind kind);
+
+    [[nodiscard]] VulkanMemoryStatistics statistics() const;
+
+private:
+    friend class VulkanAllocation;
+
+    struct Block {
+        vk::raii::DeviceMemory memory = nullptr;
+        void *mapped = nullptr;
+        vk::DeviceSize size = 0;
+        RangeAllocator ranges;
+        // Transient pages bump-allocate from `top` and reset it once every
+        // allocation in them has been freed.
+        vk::DeviceSize top = 0;
+        uint32_t allocationCount = 0;
+    };
+
+    struct Pool {
+        uint32_t memoryType = 0;
+        VulkanResourceKind kind = VulkanResourceKind::eLinear;
+        // Blocks released while empty are null and reused.
+        std::vector<std::unique_ptr<Block>> blocks;
+    };
+
+    static constexpr uint32_t kDedicated = UINT32_MAX;
+    static constexpr vk::DeviceSize kBlockSize = 64ull << 20;
+    static constexpr vk::DeviceSize kTransientPageSize = 16ull << 20;
+
+    [[nodiscard]] uint32_t findMemoryType(
+        uint32_t typeFilter, vk::MemoryPropertyFlags properties) const;
+    [[nodiscard]] vk::DeviceSize blockSize(uint32_t memoryType,
+                                           VulkanResourceKind kind) const;
+    [[nodiscard]] uint32_t poolIndex(uint32_t memoryType,
+                                     VulkanResourceKind kind);
+
+    vk::raii::DeviceMemory allocateDeviceMemory(uint32_t memoryType,
+                                                vk::DeviceSize size,
+                                                void **mapped);
+
+    VulkanAllocation allocateDedicated(uint32_t memoryType,
+                                       vk::DeviceSize size);
+    [[nodiscard]] bool allocateFromBlock(
+        uint32_t pool, uint32_t block,
+        const vk::MemoryRequirements &requirements,
+        VulkanAllocation &allocation);
+
+    void free(VulkanAllocation &allocation);
+
+    const vk::raii::Device *m_logicalDevice = nullptr;
+    vk::PhysicalDeviceMemoryProperties m_memoryProperties;
+    vk::DeviceSize m_bufferImageGranularity = 1;
+    uint32_t m_maxAllocationCount = 0;
+
+    std::vector<Pool> m_pools;
+    // Released slots are null and reused.
+    std::vector<vk::raii::DeviceMemory> m_dedicated;
+    std::vector<uint32_t> m_freeDedicated;
+
+    uint32_t m_deviceMemoryCount = 0;
+    uint32_t m_allocationCount = 0;
+    vk::DeviceSize m_dedicatedBytes = 0;
+};
+
+}  // namespace avenir::graphics::vulkan
+
+#endif  // AVENIR_GRAPHICS_VULKAN_VULKANMEMORYALLOCATOR_HPP
@@ -1,6 +1,9 @@
 #ifndef AVENIR_GRAPHICS_VULKAN_VULKANMESH_HPP
 #define AVENIR_GRAPHICS_VULKAN_VULKANMESH_HPP
 
+#include <array>
+#include <cstddef>
+
 #include <vulkan/vulkan_raii.hpp>
 
 #include "avenir/graphics/Mesh.hpp"
@@ -23,11 +26,14 @@ struct VulkanVertex final : public Vertex {
                     offsetof(VulkanVertex, color)),
 
                 vk::VertexInputAttributeDescription(
-                    2, 0, vk::Format::eR32G32B32Sfloat,
+                    2, 0, vk::Format::eR32G32Sfloat,
                     offsetof(VulkanVertex, textureCoordinates))};
     }
 };
 
+// Mesh vertices are copied to the GPU as-is.
+static_assert(sizeof(VulkanVertex) == sizeof(Vertex));
+
 class VulkanMesh final : public Mesh {
 public:
     VulkanMesh() = default;
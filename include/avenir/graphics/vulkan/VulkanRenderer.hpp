@@ -2,6 +2,7 @@
 #define VULKANRENDERER_HPP
 
 #include <array>
+#include <memory>
 #include <vector>
 #include <filesystem>
 
@@ -17,8 +18,13 @@
 
 #include "avenir/graphics/stb_image.h"
 
+#include "avenir/graphics/MeshRegistry.hpp"
 #include "avenir/graphics/Renderer.hpp"
 #include "avenir/graphics/vulkan/VulkanInstance.hpp"
+#include "avenir/graphics/vulkan/VulkanMemoryAllocator.hpp"
+#include "avenir/graphics/vulkan/VulkanMesh.hpp"
+#include "avenir/graphics/vulkan/VulkanUploader.hpp"
+#include "avenir/scene/FrustumCuller.hpp"
 
 namespace avenir::graphics::vulkan {
 class VulkanRenderer final : public Renderer {
@@ -26,41 +32,76 @@ public:
     explicit VulkanRenderer(GLFWwindow *window);
     ~VulkanRenderer() override;
 
-    void drawFrame(glm::mat4 cameraViewMatrix) override;
+    void drawFrame(scene::Scene &scene) override;
+
+    // Allocation counts and fragmentation of device memory, also logged on
+    // shutdown.
+    [[nodiscard]] VulkanMemoryStatistics memoryStatistics() const;
+    void logMemoryStatistics() const;
     void onFramebufferResize(int width, int height) override;
 
-private:
-    struct Vertex {
-        glm::vec3 position;
-        glm::vec3 color;
-        glm::vec2 textureCoordinates;
-
-        static vk::VertexInputBindingDescription getBindingDescription() {
-            return {0, sizeof(Vertex), vk::VertexInputRate::eVertex};
-        }
-
-        static std::array<vk::VertexInputAttributeDescription, 3>
-        getAttributeDescriptions() {
-            return {vk::VertexInputAttributeDescription(
-                        0, 0, vk::Format::eR32G32B32Sfloat,
-                        offsetof(Vertex, position)),
-
-                    vk::VertexInputAttributeDescription(
-                        1, 0, vk::Format::eR32G32B32Sfloat,
-                        offsetof(Vertex, color)),
-
-                    vk::VertexInputAttributeDescription(
-                        2, 0, vk::Format::eR32G32B32Sfloat,
-                        offsetof(Vertex, textureCoordinates))};
-        }
-    };
+    MeshHandle addMesh(const Mesh &mesh) override;
+    void removeMesh(MeshHandle mesh) override;
 
+private:
+    // Model matrices are read per instance from the frame's visible instance
+    // buffer.
     struct UniformBufferObject {
-        alignas(16) glm::mat4 model;
         alignas(16) glm::mat4 view;
         alignas(16) glm::mat4 projection;
     };
 
+    // The structs below mirror the std430 layout of the culling shaders.
+
+    // One gathered MeshRenderer entity: its world matrix and world AABB, and
+    // the batch of its mesh.
+    struct CullingInstance {
+        glm::mat4 world;
+        glm::vec3 center;
+        uint32_t batch;
+        glm::vec3 extents;
+        uint32_t padding;
+    };
+    static_assert(sizeof(CullingInstance) == 96);
+
+    // One mesh drawn this frame. Its visible instances are compacted into
+    // the visible instance buffer from firstInstance on.
+    struct CullingBatch {
+        uint32_t indexCount;
+        uint32_t firstIndex;
+        int32_t vertexOffset;
+        uint32_t firstInstance;
+    };
+
+    // Push constants of both culling passes.
+    struct CullingConstants {
+        std::array<glm::vec4, 6> planes;
+        uint32_t instanceCount;
+        uint32_t batchCount;
+    };
+
+    // Buffers of one frame's culling passes, grown but never shrunk.
+    struct CullingBuffers {
+        uint32_t instanceCapacity = 0;
+        uint32_t batchCapacity = 0;
+
+        // CullingInstance and CullingBatch arrays, written by the CPU.
+        vk::raii::Buffer instances = nullptr;
+        VulkanAllocation instancesMemory;
+        vk::raii::Buffer batches = nullptr;
+        VulkanAllocation batchesMemory;
+
+        // Written on the GPU: the world matrices of the visible instances,
+        // the draw count followed by the visible instance count of each
+        // batch, and a vk::DrawIndexedIndirectCommand per non-empty batch.
+        vk::raii::Buffer visibleInstances = nullptr;
+        VulkanAllocation visibleInstancesMemory;
+        vk::raii::Buffer drawCounts = nullptr;
+        VulkanAllocation drawCountsMemory;
+        vk::raii::Buffer drawCommands = nullptr;
+        VulkanAllocation drawCommandsMemory;
+    };
+
     static uint32_t chooseSwapMinImageCount(
         vk::SurfaceCapabilitiesKHR const &surfaceCapabilities);
 
@@ -77,6 +118,9 @@ private:
         const std::vector<char> &code) const;
 
     void recordCommandBuffer(uint32_t imageIndex);
+    // Culls the frame's instances and writes its draw commands, ahead of the
+    // render pass that draws them.
+    void recordCullingPasses();
 
     void transitionImageLayout(uint32_t imageIndex, vk::ImageLayout oldLayout,
                                vk::ImageLayout newLayout,
@@ -85,32 +129,35 @@ private:
                                vk::PipelineStageFlags2 sourceStageMask,
                                vk::PipelineStageFlags2 destinationStageMask);
 
-    void transitionImageLayout(const vk::raii::Image &image,
-                               vk::ImageLayout oldLayout,
-                               vk::ImageLayout newLayout);
-
     void cleanupSwapchain();
 
     void recreateSwapchain();
 
-    uint32_t findMemoryType(uint32_t typeFilter,
-                            vk::MemoryPropertyFlags properties);
-
     void createBuffer(vk::DeviceSize size, vk::BufferUsageFlags usage,
                       vk::MemoryPropertyFlags properties,
                       vk::raii::Buffer &buffer,
-                      vk::raii::DeviceMemory &bufferMemory);
-
-    void copyBuffer(const vk::raii::Buffer &sourceBuffer,
-                    const vk::raii::Buffer &destinationBuffer,
-                    vk::DeviceSize size) const;
-
-    void copyBufferToImage(const vk::raii::Buffer &buffer,
-                           const vk::raii::Image &image, uint32_t width,
-                           uint32_t height) const;
-
-    void updateUniformBuffer(uint32_t currentImage,
-                             const glm::mat4 &viewMatrix) const;
+                      VulkanAllocation &bufferMemory,
+                      VulkanResourceKind kind = VulkanResourceKind::eLinear);
+
+    // Reallocates the mesh buffers to the registry's current capacity,
+    // keeping their contents. The old buffers are retired through the
+    // uploader, so nothing waits for frames in flight.
+    void growMeshBuffers();
+    // Returns the ranges of removed meshes no frame in flight can read
+    // anymore to the registry.
+    void releaseRemovedMeshes();
+
+    void updateUniformBuffer(uint32_t currentImage, const glm::mat4 &viewMatrix,
+                             const glm::mat4 &projectionMatrix) const;
+
+    // Writes every entity gathered by the frustum culler, and a batch per
+    // mesh they use, to the frame's culling buffers.
+    void updateCullingBuffers(uint32_t currentImage);
+    void createCullingInstanceBuffers(uint32_t currentImage,
+                                      uint32_t capacity);
+    void createCullingBatchBuffers(uint32_t currentImage, uint32_t capacity);
+    // Points the frame's descriptor sets at its current culling buffers.
+    void writeCullingDescriptors(uint32_t currentImage);
 
     // std::filesystem::path getResourcePath(const std::string& relativePath);
     static std::vector<char> readFile(const std::string &fileName);
@@ -118,12 +165,7 @@ private:
     void createImage(uint32_t width, uint32_t height, vk::Format format,
                      vk::ImageTiling tiling, vk::ImageUsageFlags usage,
                      vk::MemoryPropertyFlags properties, vk::raii::Image &image,
-                     vk::raii::DeviceMemory &imageMemory);
-
-    [[nodiscard]] vk::raii::CommandBuffer beginSingleTimeCommands() const;
-
-    void endSingleTimeCommands(
-        const vk::raii::CommandBuffer &commandBuffer) const;
+                     VulkanAllocation &imageMemory);
 
     [[nodiscard]] vk::raii::ImageView createImageView(vk::raii::Image &image,
                                                       vk::Format format);
@@ -135,13 +177,15 @@ private:
     void createImageViews();
     void createDescriptorSetLayout();
     void createGraphicsPipeline();
+    void createCullingPipelines();
     void createCommandPool();
+    void createUploader();
     void createTextureImage();
     void createTextureImageView();
     void createTextureSampler();
-    void createVertexBuffer();
-    void createIndexBuffer();
+    void createMeshBuffers();
     void createUniformBuffers();
+    void createCullingBuffers();
     void createDescriptorPool();
     void createDescriptorSets();
     void createCommandBuffers();
@@ -158,6 +202,12 @@ private:
     vk::raii::Queue m_queue = nullptr;
     uint32_t m_queueIndex = ~0;
 
+    // Backs every buffer and image below, so it is declared before them and
+    // destroyed after them.
+    std::unique_ptr<VulkanMemoryAllocator> m_memoryAllocator;
+    // Records buffer and image uploads, submitted ahead of each frame.
+    std::unique_ptr<VulkanUploader> m_uploader;
+
     vk::raii::SwapchainKHR m_swapchain = nullptr;
     std::vector<vk::Image> m_swapchainImages;
     vk::SurfaceFormatKHR m_swapchainSurfaceFormat;
@@ -167,23 +217,61 @@ private:
     vk::raii::DescriptorSetLayout m_descriptorSetLayout = nullptr;
     vk::raii::PipelineLayout m_pipelineLayout = nullptr;
     vk::raii::Pipeline m_graphicsPipeline = nullptr;
+
+    // Set 1 of the culling passes, which share the shader module, and so set
+    // 0, with the graphics pipeline.
+    vk::raii::DescriptorSetLayout m_cullingDescriptorSetLayout = nullptr;
+    vk::raii::PipelineLayout m_cullingPipelineLayout = nullptr;
+    // Tests each instance against the frustum and appends the visible ones to
+    // their batch.
+    vk::raii::Pipeline m_cullingPipeline = nullptr;
+    // Writes a draw command for each batch left with visible instances.
+    vk::raii::Pipeline m_compactionPipeline = nullptr;
     vk::raii::CommandPool m_commandPool = nullptr;
 
     vk::raii::Image m_textureImage = nullptr;
-    vk::raii::DeviceMemory m_textureImageMemory = nullptr;
+    VulkanAllocation m_textureImageMemory = nullptr;
     vk::raii::ImageView m_textureImageView = nullptr;
     vk::raii::Sampler m_textureSampler = nullptr;
 
+    // Every mesh, packed by m_meshRegistry into one vertex buffer and one
+    // index buffer so a frame binds each only once.
+    static constexpr uint32_t m_kInitialMeshVertexCapacity = 1 << 16;
+    static constexpr uint32_t m_kInitialMeshIndexCapacity = 1 << 18;
+    MeshRegistry m_meshRegistry{m_kInitialMeshVertexCapacity,
+                                m_kInitialMeshIndexCapacity};
     vk::raii::Buffer m_vertexBuffer = nullptr;
-    vk::raii::DeviceMemory m_vertexBufferMemory = nullptr;
+    VulkanAllocation m_vertexBufferMemory = nullptr;
     vk::raii::Buffer m_indexBuffer = nullptr;
-    vk::raii::DeviceMemory m_indexBufferMemory = nullptr;
+    VulkanAllocation m_indexBufferMemory = nullptr;
+    uint32_t m_vertexBufferCapacity = 0;
+    uint32_t m_indexBufferCapacity = 0;
+
+    // Ranges of removed meshes, with the number of frames submitted at
+    // removal; the last of those frames may still read them.
+    struct RemovedMesh {
+        MeshRange range;
+        uint64_t frame = 0;
+    };
+    std::vector<RemovedMesh> m_removedMeshes;
+    uint64_t m_submittedFrames = 0;
+
     std::vector<vk::raii::Buffer> m_uniformBuffers;
-    std::vector<vk::raii::DeviceMemory> m_uniformBuffersMemory;
-    std::vector<void *> m_uniformBuffersMapped;
+    std::vector<VulkanAllocation> m_uniformBuffersMemory;
+
+    static constexpr uint32_t m_kInitialCullingInstanceCapacity = 1024;
+    static constexpr uint32_t m_kInitialCullingBatchCapacity = 64;
+    // Matches numthreads of the culling shaders.
+    static constexpr uint32_t m_kCullingGroupSize = 64;
+    std::vector<CullingBuffers> m_cullingBuffers;
+    CullingConstants m_cullingConstants{};
+    std::vector<CullingBatch> m_cullingBatches;
+    // Index into m_cullingBatches per mesh registry slot, while batching.
+    std::vector<uint32_t> m_meshBatches;
 
     vk::raii::DescriptorPool m_descriptorPool = nullptr;
     std::vector<vk::raii::DescriptorSet> m_descriptorSets;
+    std::vector<vk::raii::DescriptorSet> m_cullingDescriptorSets;
 
     std::vector<vk::raii::CommandBuffer> m_commandBuffers;
     std::vector<vk::raii::Semaphore> m_presentCompleteSemaphores;
@@ -195,6 +283,10 @@ private:
     bool m_framebufferResized = false;
     bool m_isFirstRun = true;
 
+    // Camera matrices and MeshRenderer entities of the current frame, culled
+    // on the GPU.
+    scene::FrustumCuller m_frustumCuller;
+
     const std::vector<const char *> m_deviceExtensions = {
         vk::KHRSwapchainExtensionName, vk::KHRSpirv14ExtensionName,
         vk::KHRSynchronization2ExtensionName,
@@ -203,49 +295,6 @@ private:
         "VK_KHR_portability_subset"
 #endif
     };
-
-    /*
-     * Vulkan and glTF models by default handles vertices in a
-     * counter-clockwise winding order, as shown below how our quad is being
-     * rendered.
-     *
-     * Vertices:    UV Coordinates:
-     * 3  2         0,0  1,0
-     * +--+           +--+
-     * | /|           | /|
-     * |/ |           |/ |
-     * +--+           +--+
-     * 0  1         0,1  1,1
-     */
-    const std::vector<Vertex> m_vertices = {
-        // Front face
-        {{-0.5f, -0.5f, 0.5f}, {1.0f, 1.0f, 1.0f}, {0.0f, 1.0f}},
-        {{0.5f, -0.5f, 0.5f}, {1.0f, 1.0f, 1.0f}, {1.0f, 1.0f}},
-        {{0.5f, 0.5f, 0.5f}, {1.0f, 1.0f, 1.0f}, {1.0f, 0.0f}},
-        {{-0.5f, 0.5f, 0.5f}, {1.0f, 1.0f, 1.0f}, {0.0f, 0.0f}},
-
-        // Back face
-        {{0.5f, -0.5f, -0.5f}, {1.0f, 1.0f, 1.0f}, {0.0f, 1.0f}},
-        {{-0.5f, -0.5f, -0.5f}, {1.0f, 1.0f, 1.0f}, {1.0f, 1.0f}},
-        {{-0.5f, 0.5f, -0.5f}, {1.0f, 1.0f, 1.0f}, {1.0f, 0.0f}},
-        {{0.5f, 0.5f, -0.5f}, {1.0f, 1.0f, 1.0f}, {0.0f, 0.0f}}};
-
-    const std::vector<uint16_t> m_indices = {// Front
-                                             0, 1, 2, 2, 3, 0,
-
-                                             // Back
-                                             4, 5, 6, 6, 7, 4,
-
-                                             // Left
-                                             5, 0, 3, 3, 6, 5,
-
-                                             // Right
-                                             1, 4, 7, 7, 2, 1,
-
-                                             // Top
-                                             3, 2, 7, 7, 6, 3,
-                                             // Bottom
-                                             5, 4, 1, 1, 0, 5};
 };
 }  // namespace avenir::graphics::vulkan
 #endif  // VULKANRENDERER_HPP
\ No newline at end of file
@@ -0,0 +1,122 @@
+#ifndef AVENIR_GRAPHICS_VULKAN_VULKANUPLOADER_HPP
+#define AVENIR_GRAPHICS_VULKAN_VULKANUPLOADER_HPP
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include "avenir/graphics/vulkan/VulkanMemoryAllocator.hpp"
+
+namespace avenir::graphics::vulkan {
+
+/*
+ * Streams data to device-local buffers and images without stalling the
+ * queue. Data is copied into a persistently mapped staging ring and the
+ * transfers are recorded into a batch command buffer; submit() hands the
+ * batch to the queue behind a fence, and the ring space and anything
+ * retired with the batch are reclaimed once that fence has signalled.
+ *
+ * Batches are submitted to the graphics queue ahead of the frame that first
+ * uses their data and end in a memory barrier, so that frame sees the data
+ * without waiting on the CPU. Only a ring too full for an upload makes the
+ * uploader wait, for the oldest batch; uploads larger than the whole ring
+ * go through a transient staging buffer instead.
+ *
+ * Not thread-safe.
+ */
+class VulkanUploader {
+public:
+    VulkanUploader(const vk::raii::Device &logicalDevice,
+                   const vk::raii::Queue &queue, uint32_t queueFamilyIndex,
+                   VulkanMemoryAllocator &memoryAllocator,
+                   vk::DeviceSize ringSize = kDefaultRingSize);
+    // Waits for every submitted batch.
+    ~VulkanUploader();
+
+    VulkanUploader(const VulkanUploader &) = delete;
+    VulkanUploader &operator=(const VulkanUploader &) = delete;
+
+    void uploadBuffer(const void *data, vk::DeviceSize size,
+                      const vk::raii::Buffer &destinationBuffer,
+                      vk::DeviceSize destinationOffset);
+
+    // Fills the whole of a single-mip, single-layer colour image, which ends
+    // in eShaderReadOnlyOptimal.
+    void uploadImage(const void *data, vk::DeviceSize size,
+                     const vk::raii::Image &image, uint32_t width,
+                     uint32_t height);
+
+    // Device-side copy between buffers, ordered after the uploads recorded
+    // before it.
+    void copyBuffer(const vk::raii::Buffer &sourceBuffer,
+                    const vk::raii::Buffer &destinationBuffer,
+                    vk::DeviceSize size);
+
+    // Destroys `buffer` once the queue has finished everything submitted so
+    // far and everything recorded into the current batch.
+    void retire(vk::raii::Buffer buffer, VulkanAllocation memory);
+
+    // Submits the uploads recorded since the last call, if any. Work
+    // submitted to the queue afterwards sees their results.
+    void submit();
+
+private:
+    struct StagedData {
+        vk::Buffer buffer;
+        vk::DeviceSize offset = 0;
+    };
+
+    struct RetiredBuffer {
+        vk::raii::Buffer buffer = nullptr;
+        VulkanAllocation memory;
+    };
+
+    struct Batch {
+        vk::raii::CommandBuffer commandBuffer = nullptr;
+        vk::raii::Fence fence = nullptr;
+        // Ring position up to which this batch's staging data reaches.
+        uint64_t ringEnd = 0;
+        std::vector<RetiredBuffer> retired;
+    };
+
+    static constexpr vk::DeviceSize kDefaultRingSize = 16ull << 20;
+    // Satisfies the bufferOffset rules of copies to images of every colour
+    // format.
+    static constexpr vk::DeviceSize kStagingAlignment = 16;
+
+    // Copies `data` into the ring, waiting for old batches if it is full.
+    // Data larger than the whole ring goes to a transient buffer retired
+    // with the current batch instead.
+    [[nodiscard]] StagedData stage(const void *data, vk::DeviceSize size);
+    [[nodiscard]] bool tryReserve(vk::DeviceSize size, uint64_t &position);
+
+    const vk::raii::CommandBuffer &recordingCommandBuffer();
+    void reclaimCompletedBatches();
+    void waitForOldestBatch();
+
+    const vk::raii::Device &m_logicalDevice;
+    const vk::raii::Queue &m_queue;
+    VulkanMemoryAllocator &m_memoryAllocator;
+
+    vk::raii::CommandPool m_commandPool = nullptr;
+
+    vk::raii::Buffer m_ringBuffer = nullptr;
+    VulkanAllocation m_ringMemory;
+    vk::DeviceSize m_ringSize = 0;
+    // Byte positions that only grow while any batch is in flight; the ring
+    // offset is position % m_ringSize. Data between tail and head belongs to
+    // unfinished batches.
+    uint64_t m_ringHead = 0;
+    uint64_t m_ringTail = 0;
+
+    Batch m_recording;
+    bool m_isRecording = false;
+    std::deque<Batch> m_submittedBatches;
+    std::vector<Batch> m_idleBatches;
+};
+
+}  // namespace avenir::graphics::vulkan
+
+#endif  // AVENIR_GRAPHICS_VULKAN_VULKANUPLOADER_HPP
@@ -0,0 +1,182 @@
+#ifndef AVENIR_JOBS_JOBSYSTEM_HPP
+#define AVENIR_JOBS_JOBSYSTEM_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace avenir::jobs {
+
+using Job = std::function<void()>;
+
+/*
+ * Counts outstanding jobs. Every job submitted against a counter increments it
+ * and decrements it on completion, so a counter reaching zero means all of its
+ * jobs have finished. Jobs can also be made to wait on a counter with
+ * JobSystem::runAfter(), which is how dependencies between batches are
+ * expressed. A counter must outlive the jobs that signal it.
+ */
+class Counter {
+public:
+    Counter() = default;
+
+    Counter(const Counter &) = delete;
+    Counter &operator=(const Counter &) = delete;
+
+    [[nodiscard]] bool isDone() const;
+
+private:
+    friend class JobSystem;
+
+    std::atomic<uint32_t> m_pending = 0;
+
+    // Guards the drop to zero as well as the continuations, so a waiter that
+    // sees the counter done can destroy it without racing the last job.
+    mutable std::mutex m_mutex;
+    std::vector<std::pair<Job, Counter *>> m_continuations;
+};
+
+/*
+ * Work-stealing thread pool. Each worker owns a deque: jobs it spawns are
+ * pushed to and popped from the back, while idle workers steal from the front
+ * of another worker's deque. Jobs submitted from outside the pool go through
+ * a shared queue. Waiting on a counter never blocks a thread outright; the
+ * waiter runs other jobs until the counter is done, so jobs may freely wait
+ * on jobs they spawned.
+ *
+ * The thread that constructs the JobSystem is its main thread. Jobs submitted
+ * with runOnMainThread() only ever run there, from wait() or
+ * processMainThreadJobs(), which is what window and input calls into GLFW
+ * need.
+ *
+ * Jobs must not let exceptions escape.
+ */
+class JobSystem {
+public:
+    // Uses one worker per hardware thread besides the calling one.
+    JobSystem();
+    explicit JobSystem(uint32_t workerCount);
+    ~JobSystem();
+
+    JobSystem(const JobSystem &) = delete;
+    JobSystem &operator=(const JobSystem &) = delete;
+
+    // Process-wide pool used by the engine's own subsystems. Created on first
+    // use, so the first caller becomes its main thread.
+    static JobSystem &shared();
+
+    void run(Job job, Counter *counter = nullptr);
+    // Runs `job` once `dependency` reaches zero.
+    void runAfter(Counter &dependency, Job job, Counter *counter = nullptr);
+    void runOnMainThread(Job job, Counter *counter = nullptr);
+
+    // Runs other jobs until the counter reaches zero.
+    void wait(const Counter &counter);
+
+    // Splits [begin, end) into ranges of at least `grainSize` indices, calls
+    // function(rangeBegin, rangeEnd) for each across the pool and returns
+    // once all have finished.
+    template <typename Function>
+    void parallelFor(uint32_t begin, uint32_t end, uint32_t grainSize,
+                     Function &&function);
+
+    // Drains jobs queued with runOnMainThread(). Call once per frame from the
+    // main thread if it does not otherwise wait on the pool.
+    void processMainThreadJobs();
+
+    // Number of pool threads, excluding the main thread.
+    [[nodiscard]] uint32_t workerCount() const;
+    [[nodiscard]] bool isMainThread() const;
+
+private:
+    struct QueuedJob {
+        Job job;
+        Counter *counter;
+    };
+
+    struct Worker {
+        std::mutex mutex;
+        std::deque<QueuedJob> jobs;
+    };
+
+    void submit(QueuedJob job);
+    void execute(QueuedJob &job);
+    void finish(Counter *counter);
+    bool tryRunJob(std::optional<uint32_t> self);
+    bool tryRunMainThreadJob();
+    void workerLoop(const std::stop_token &stopToken, uint32_t index);
+
+    std::thread::id m_mainThread;
+    std::vector<std::unique_ptr<Worker>> m_workers;
+
+    std::mutex m_sharedMutex;
+    std::deque<QueuedJob> m_sharedJobs;
+
+    std::mutex m_mainThreadMutex;
+    std::deque<QueuedJob> m_mainThreadJobs;
+
+    // Jobs sitting in worker or shared queues; lets idle workers sleep
+    // without missing a submission.
+    std::atomic<uint64_t> m_queuedJobs = 0;
+    std::mutex m_sleepMutex;
+    std::condition_variable_any m_wakeCondition;
+
+    // Declared last so threads are joined before the queues they use die.
+    std::vector<std::jthread> m_threads;
+};
+
+template <typename Function>
+void JobSystem::parallelFor(const uint32_t begin, const uint32_t end,
+                            const uint32_t grainSize, Function &&function) {
+    if (begin >= end) {
+        return;
+    }
+
+    // A few ranges per thread leaves room for stealing to even out uneven
+    // work without paying for a job per index.
+    const uint32_t count = end - begin;
+    const uint32_t threads = workerCount() + 1;
+    const uint32_t rangeCount = std::max(
+        1u, std::min(threads * 4, count / std::max(1u, grainSize)));
+
+    if (rangeCount == 1) {
+        function(begin, end);
+        return;
+    }
+
+    Counter counter;
+    for (uint32_t range = 1; range < rangeCount; range++) {
+        const uint32_t rangeBegin =
+            begin + static_cast<uint32_t>(uint64_t{count} * range / rangeCount);
+        const uint32_t rangeEnd = begin + static_cast<uint32_t>(
+                                              uint64_t{count} * (range + 1) /
+                                              rangeCount);
+        run(
+            [&function, rangeBegin, rangeEnd] {
+                function(rangeBegin, rangeEnd);
+            },
+            &counter);
+    }
+
+    try {
+        function(begin, begin + count / rangeCount);
+    } catch (...) {
+        // The other ranges still reference `function` and `counter`.
+        wait(counter);
+        throw;
+    }
+
+    wait(counter);
+}
+
+}  // namespace avenir::jobs
+
+#endif  // AVENIR_JOBS_JOBSYSTEM_HPP
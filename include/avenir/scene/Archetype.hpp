@@ -0,0 +1,216 @@
+#ifndef AVENIR_SCENE_ARCHETYPE_HPP
+#define AVENIR_SCENE_ARCHETYPE_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "avenir/scene/ChunkAllocator.hpp"
+#include "avenir/scene/ComponentInfo.hpp"
+
+namespace avenir::scene {
+
+/*
+ * Storage for every entity sharing the exact same set of components.
+ *
+ * Entities are packed into fixed-size chunks. Each chunk holds one contiguous
+ * array per component type (plus an array of owning entity slot indices), so
+ * iterating a single component type over an archetype is a linear walk through
+ * memory.
+ * Rows are kept dense: removing a row moves the last row into the hole.
+ *
+ * Column lookups go through a table indexed by ComponentTypeId, and the
+ * archetype's component set is a bitmask, so both are O(1).
+ *
+ * Every component of every row carries the scene tick at which it was last
+ * written, and each chunk keeps the newest tick per column, so change queries
+ * can skip whole chunks that have not been touched.
+ *
+ * Chunks are reference counted so a SceneSnapshot can keep reading them while
+ * the scene moves on. Every mutating member first copies a shared chunk into a
+ * private one (copy-on-write), so only chunks written after a snapshot are
+ * duplicated. The copy may happen on any thread writing through the archetype;
+ * the replaced chunk stays readable until releaseRetiredChunks() is called at
+ * the next point where no system is running.
+ */
+class Archetype {
+public:
+    static constexpr std::size_t kChunkSize = ChunkAllocator::kBlockSize;
+    // Room at the start of each chunk for its reference count.
+    static constexpr std::size_t kChunkHeaderSize =
+        ChunkAllocator::kBlockAlignment;
+
+    Archetype(std::vector<const ComponentInfo *> components,
+              ChunkAllocator &allocator);
+    ~Archetype();
+
+    Archetype(const Archetype &) = delete;
+    Archetype &operator=(const Archetype &) = delete;
+
+    [[nodiscard]] const std::vector<const ComponentInfo *> &components() const;
+    [[nodiscard]] const ComponentMask &mask() const;
+    [[nodiscard]] bool contains(const ComponentInfo &info) const;
+    [[nodiscard]] std::optional<std::size_t> columnIndex(
+        const ComponentInfo &info) const;
+
+    [[nodiscard]] uint32_t size() const;
+    [[nodiscard]] uint32_t chunkCapacity() const;
+    [[nodiscard]] std::size_t chunkCount() const;
+    [[nodiscard]] uint32_t chunkSize(std::size_t chunk) const;
+
+    // Appends a row for the given entity slot index, stamped with `tick`.
+    // Component memory is left uninitialised and must be constructed by the
+    // caller.
+    uint32_t pushRow(uint32_t entity, uint32_t tick);
+
+    // Appends one row per entity slot index; the rows are contiguous and the
+    // first is returned. Component memory is left uninitialised.
+    uint32_t pushRows(std::span<const uint32_t> entities, uint32_t tick);
+
+    // Copy-constructs *source into `count` rows of `column` starting at
+    // `firstRow`, one copyFill() call per chunk spanned.
+    void fillColumn(std::size_t column, uint32_t firstRow, uint32_t count,
+                    const void *source);
+
+    // Moves every component this archetype shares with the destination into
+    // its row, keeping their change ticks, and destroys the remaining ones.
+    // The source row is left for eraseRow().
+    void moveRowTo(uint32_t row, Archetype &destination,
+                   uint32_t destinationRow);
+
+    void destroyRow(uint32_t row);
+
+    // Removes a row whose components were already moved out or destroyed by
+    // relocating the last row into it. Returns the slot index of the relocated
+    // entity.
+    std::optional<uint32_t> eraseRow(uint32_t row);
+
+    [[nodiscard]] void *componentAt(std::size_t column, uint32_t row);
+    [[nodiscard]] const void *componentAt(std::size_t column,
+                                          uint32_t row) const;
+    [[nodiscard]] uint32_t entityAt(uint32_t row) const;
+
+    [[nodiscard]] std::span<const uint32_t> entities(std::size_t chunk) const;
+
+    [[nodiscard]] uint32_t changeTick(std::size_t column, uint32_t row) const;
+    // Safe to call concurrently for distinct rows.
+    void setChangeTick(std::size_t column, uint32_t row, uint32_t tick);
+    // Newest change tick of any row of `column` within the chunk.
+    [[nodiscard]] uint32_t chunkChangeTick(std::size_t chunk,
+                                           std::size_t column) const;
+    [[nodiscard]] std::span<const uint32_t> changeTicks(
+        std::size_t chunk, std::size_t column) const;
+    // Stamps every row of `column` within the chunk.
+    void markChunkChanged(std::size_t chunk, std::size_t column, uint32_t tick);
+
+    // Mutable access copies the chunk first if a snapshot shares it.
+    template <typename T>
+    [[nodiscard]] std::span<T> components(std::size_t chunk) {
+        const std::optional<std::size_t> column =
+            columnIndex(componentInfo<T>());
+        if (!column) {
+            return {};
+        }
+
+        return {reinterpret_cast<T *>(writableChunk(chunk) +
+                                      m_columnOffsets[*column]),
+                chunkSize(chunk)};
+    }
+
+    template <typename T>
+    [[nodiscard]] std::span<const T> components(std::size_t chunk) const {
+        const std::optional<std::size_t> column =
+            columnIndex(componentInfo<T>());
+        if (!column) {
+            return {};
+        }
+
+        return {reinterpret_cast<const T *>(chunkData(chunk) +
+                                            m_columnOffsets[*column]),
+                chunkSize(chunk)};
+    }
+
+    // Whether every component type can be copied, as sharing requires.
+    [[nodiscard]] bool isShareable() const;
+
+    // Adds a reference to the chunk for a snapshot and returns its memory.
+    // The next write to the chunk through this archetype copies it, so the
+    // archetype must be shareable. Not safe to call while other threads write
+    // to the archetype.
+    [[nodiscard]] std::byte *shareChunk(std::size_t chunk);
+    // Drops a reference taken by shareChunk(); the last one destroys the
+    // chunk's `rows` rows and frees it. Safe to call from any thread.
+    void releaseChunk(std::byte *chunk, uint32_t rows) const;
+    // Drops the archetype's own references to chunks replaced by
+    // copy-on-write since the last call.
+    void releaseRetiredChunks();
+
+    // Read access to a chunk returned by shareChunk().
+    [[nodiscard]] std::span<const uint32_t> sharedEntities(
+        const std::byte *chunk, uint32_t rows) const;
+    [[nodiscard]] const void *sharedColumn(const std::byte *chunk,
+                                           std::size_t column) const;
+
+    Archetype *addEdge(const ComponentInfo &info) const;
+    Archetype *removeEdge(const ComponentInfo &info) const;
+    void setAddEdge(const ComponentInfo &info, Archetype *archetype);
+    void setRemoveEdge(const ComponentInfo &info, Archetype *archetype);
+
+private:
+    struct ChunkHeader {
+        std::atomic<uint32_t> references;
+    };
+
+    struct RetiredChunk {
+        std::byte *chunk;
+        uint32_t rows;
+    };
+
+    [[nodiscard]] std::byte *allocateChunk() const;
+    // Loads the chunk pointer, which writableChunk() may swap concurrently.
+    [[nodiscard]] std::byte *chunkData(std::size_t chunk) const;
+    // Returns the chunk's memory, first replacing it with a private copy if a
+    // snapshot shares it.
+    [[nodiscard]] std::byte *writableChunk(std::size_t chunk);
+    [[nodiscard]] std::byte *copyChunk(const std::byte *source,
+                                       uint32_t rows) const;
+    void destroyRows(std::byte *chunk, uint32_t rows) const;
+
+    [[nodiscard]] std::byte *rowAddress(std::byte *chunk, std::size_t column,
+                                        uint32_t row) const;
+    [[nodiscard]] uint32_t *entityAddress(std::byte *chunk, uint32_t row) const;
+    [[nodiscard]] uint32_t *tickAddress(std::byte *chunk, std::size_t column,
+                                        uint32_t row) const;
+
+    static constexpr uint8_t kNoColumn = 0xFF;
+
+    std::vector<const ComponentInfo *> m_components;
+    ComponentMask m_mask;
+    std::array<uint8_t, kMaxComponentTypes> m_columnByType{};
+    std::vector<std::size_t> m_columnOffsets;
+    std::size_t m_chunkBytes = kChunkSize;
+    uint32_t m_chunkCapacity = 0;
+
+    ChunkAllocator *m_allocator;
+    std::vector<std::byte *> m_chunks;
+    // Nonzero while a snapshot holds a reference to the chunk, so the next
+    // write copies it. Set only between frames; cleared under m_copyMutex.
+    std::vector<uint8_t> m_chunkShared;
+    std::vector<RetiredChunk> m_retiredChunks;
+    std::mutex m_copyMutex;
+    // Indexed by chunk * column count + column.
+    std::vector<uint32_t> m_chunkTicks;
+    uint32_t m_size = 0;
+
+    std::array<Archetype *, kMaxComponentTypes> m_addEdges{};
+    std::array<Archetype *, kMaxComponentTypes> m_removeEdges{};
+};
+
+}  // namespace avenir::scene
+
+#endif  // AVENIR_SCENE_ARCHETYPE_HPP
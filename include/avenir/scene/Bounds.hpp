@@ -0,0 +1,82 @@
+#ifndef AVENIR_SCENE_BOUNDS_HPP
+#define AVENIR_SCENE_BOUNDS_HPP
+
+#include <array>
+#include <optional>
+
+#include <glm/common.hpp>
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+namespace avenir::scene {
+
+// Axis-aligned bounding box.
+struct Aabb {
+    glm::vec3 min = glm::vec3(0.0f);
+    glm::vec3 max = glm::vec3(0.0f);
+
+    // The small helpers are inline: tree insertion calls them per node.
+    [[nodiscard]] glm::vec3 center() const { return (min + max) * 0.5f; }
+    [[nodiscard]] glm::vec3 extents() const { return (max - min) * 0.5f; }
+
+    [[nodiscard]] float surfaceArea() const {
+        const glm::vec3 size = max - min;
+        return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+    }
+
+    [[nodiscard]] bool contains(const Aabb &other) const {
+        return min.x <= other.min.x && min.y <= other.min.y &&
+               min.z <= other.min.z && other.max.x <= max.x &&
+               other.max.y <= max.y && other.max.z <= max.z;
+    }
+
+    [[nodiscard]] bool overlaps(const Aabb &other) const {
+        return min.x <= other.max.x && other.min.x <= max.x &&
+               min.y <= other.max.y && other.min.y <= max.y &&
+               min.z <= other.max.z && other.min.z <= max.z;
+    }
+
+    [[nodiscard]] Aabb merged(const Aabb &other) const {
+        return {glm::min(min, other.min), glm::max(max, other.max)};
+    }
+
+    [[nodiscard]] Aabb expanded(const float margin) const {
+        return {min - glm::vec3(margin), max + glm::vec3(margin)};
+    }
+
+    // Smallest box enclosing this one after transformation by `matrix`.
+    [[nodiscard]] Aabb transformed(const glm::mat4 &matrix) const;
+};
+
+struct Ray {
+    glm::vec3 origin = glm::vec3(0.0f);
+    glm::vec3 direction = glm::vec3(0.0f, 0.0f, -1.0f);
+
+    // Distance along the ray at which it enters `box`, if it does so within
+    // [0, maxDistance]. A ray starting inside the box hits it at 0.
+    [[nodiscard]] std::optional<float> intersect(const Aabb &box,
+                                                 float maxDistance) const;
+};
+
+/*
+ * Six inward-facing planes (left, right, bottom, top, near, far) stored as
+ * (normal, distance), so a point p is inside a plane when
+ * dot(normal, p) + distance >= 0.
+ */
+struct Frustum {
+    enum class Containment { eOutside, eIntersecting, eInside };
+
+    std::array<glm::vec4, 6> planes;
+
+    // Extracts the planes of a combined projection * view matrix. The near
+    // plane assumes a -1..1 clip depth range, which is conservative for 0..1.
+    static Frustum fromMatrix(const glm::mat4 &viewProjection);
+
+    [[nodiscard]] bool intersects(const Aabb &box) const;
+    [[nodiscard]] Containment classify(const Aabb &box) const;
+};
+
+}  // namespace avenir::scene
+
+#endif  // AVENIR_SCENE_BOUNDS_HPP
@@ -0,0 +1,66 @@
+#ifndef AVENIR_SCENE_CHUNKALLOCATOR_HPP
+#define AVENIR_SCENE_CHUNKALLOCATOR_HPP
+
+#include <cstddef>
+#include <mutex>
+
+namespace avenir::scene {
+
+struct AllocationStats {
+    // Blocks requested from / returned to the global heap.
+    std::size_t heapAllocations = 0;
+    std::size_t heapDeallocations = 0;
+    // Blocks handed out from the free list without touching the heap.
+    std::size_t pooledAllocations = 0;
+
+    std::size_t blocksInUse = 0;
+    std::size_t blocksFree = 0;
+};
+
+/*
+ * Fixed-size block pool backing archetype chunks. Released blocks go onto an
+ * intrusive free list and are reused by the next chunk of any archetype, so
+ * once a scene has reached its working size, creating, moving and destroying
+ * entities allocates nothing from the global heap. Blocks larger than
+ * kBlockSize (archetypes with huge components) bypass the pool.
+ *
+ * allocate() and deallocate() may be called from any thread: chunks are
+ * copied on write from job threads and released by snapshots on the render
+ * thread.
+ */
+class ChunkAllocator {
+public:
+    static constexpr std::size_t kBlockSize = 16 * 1024;
+    static constexpr std::size_t kBlockAlignment = 64;
+
+    ChunkAllocator() = default;
+    ~ChunkAllocator();
+
+    ChunkAllocator(const ChunkAllocator &) = delete;
+    ChunkAllocator &operator=(const ChunkAllocator &) = delete;
+
+    [[nodiscard]] std::byte *allocate(std::size_t size);
+    void deallocate(std::byte *block, std::size_t size);
+
+    // Returns every free block to the global heap.
+    void releaseFreeBlocks();
+
+    // Not synchronised; read while no other thread is using the allocator.
+    [[nodiscard]] const AllocationStats &stats() const;
+
+private:
+    struct FreeBlock {
+        FreeBlock *next;
+    };
+
+    static std::byte *allocateFromHeap(std::size_t size);
+    static void deallocateToHeap(std::byte *block, std::size_t size);
+
+    std::mutex m_mutex;
+    FreeBlock *m_freeList = nullptr;
+    AllocationStats m_stats;
+};
+
+}  // namespace avenir::scene
+
+#endif  // AVENIR_SCENE_CHUNKALLOCATOR_HPP
@@ -1,15 +1,11 @@
 #ifndef AVENIR_SCENE_COMPONENT_HPP
 #define AVENIR_SCENE_COMPONENT_HPP
 
-#include <string>
-#include <memory>
-
-struct Component {
-    virtual ~Component() = default;
-
-    [[nodiscard]] virtual std::unique_ptr<Component> clone() const = 0;
-
-    [[nodiscard]] virtual std::string name() const = 0;
-};
+/*
+ * Base for component types. Components are plain data: scene storage moves,
+ * copies and destroys them through their ComponentInfo, so the base carries no
+ * virtual functions and simple components stay trivially copyable.
+ */
+struct Component {};
 
 #endif  // AVENIR_SCENE_COMPONENT_HPP
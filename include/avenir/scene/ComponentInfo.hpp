@@ -0,0 +1,105 @@
+#ifndef AVENIR_SCENE_COMPONENTINFO_HPP
+#define AVENIR_SCENE_COMPONENTINFO_HPP
+
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <string_view>
+#include <type_traits>
+
+#include "avenir/scene/Component.hpp"
+#include "avenir/scene/ComponentType.hpp"
+
+namespace avenir::scene {
+
+/*
+ * Type-erased description of a component type, used by archetype storage to
+ * move, copy and destroy components it only knows as raw bytes. Every
+ * instance is static and recorded in the ComponentRegistry, so tooling can
+ * enumerate and handle components generically without virtual calls or heap
+ * allocation.
+ */
+struct ComponentInfo {
+    ComponentTypeId id;
+    std::string_view name;
+    std::size_t size;
+    std::size_t alignment;
+    // Whether instances may be copied and relocated with memcpy.
+    bool triviallyCopyable;
+
+    void (*moveConstruct)(void *destination, void *source);
+    // Null when the type is not copy constructible.
+    void (*copyConstruct)(void *destination, const void *source);
+    // Constructs `count` consecutive copies of *source at `destination`, with
+    // a plain memcpy per copy for trivially copyable types. Null when the type
+    // is not copy constructible.
+    void (*copyFill)(void *destination, const void *source, std::size_t count);
+    void (*destroy)(void *pointer);
+};
+
+// Records `info` in the ComponentRegistry. Called once per type by
+// componentInfo<T>().
+void registerComponentInfo(const ComponentInfo &info);
+
+template <typename T>
+constexpr auto componentCopyConstruct() -> void (*)(void *, const void *) {
+    if constexpr (!std::is_copy_constructible_v<T>) {
+        return nullptr;
+    } else {
+        return [](void *destination, const void *source) {
+            std::construct_at(static_cast<T *>(destination),
+                              *static_cast<const T *>(source));
+        };
+    }
+}
+
+template <typename T>
+constexpr auto componentCopyFill()
+    -> void (*)(void *, const void *, std::size_t) {
+    if constexpr (!std::is_copy_constructible_v<T>) {
+        return nullptr;
+    } else {
+        return [](void *destination, const void *source,
+                  const std::size_t count) {
+            if constexpr (std::is_trivially_copyable_v<T>) {
+                auto *bytes = static_cast<std::byte *>(destination);
+                for (std::size_t i = 0; i < count; i++) {
+                    std::memcpy(bytes + i * sizeof(T), source, sizeof(T));
+                }
+            } else {
+                std::uninitialized_fill_n(static_cast<T *>(destination), count,
+                                          *static_cast<const T *>(source));
+            }
+        };
+    }
+}
+
+template <typename T>
+const ComponentInfo &componentInfo() {
+    static_assert(std::is_base_of_v<Component, T>,
+                  "T must derive from Component");
+    static_assert(std::is_nothrow_move_constructible_v<T>,
+                  "Components must be nothrow move constructible");
+
+    static const ComponentInfo info{
+        componentTypeId<T>(),
+        T::staticName,
+        sizeof(T),
+        alignof(T),
+        std::is_trivially_copyable_v<T>,
+        [](void *destination, void *source) {
+            std::construct_at(static_cast<T *>(destination),
+                              std::move(*static_cast<T *>(source)));
+        },
+        componentCopyConstruct<T>(),
+        componentCopyFill<T>(),
+        [](void *pointer) { std::destroy_at(static_cast<T *>(pointer)); }};
+    static const bool registered = (registerComponentInfo(info), true);
+    (void)registered;
+
+    return info;
+}
+
+}  // namespace avenir::scene
+
+#endif  // AVENIR_SCENE_COMPONENTINFO_HPP
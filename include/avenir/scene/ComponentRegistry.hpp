@@ -0,0 +1,41 @@
+#ifndef AVENIR_SCENE_COMPONENTREGISTRY_HPP
+#define AVENIR_SCENE_COMPONENTREGISTRY_HPP
+
+#include <string_view>
+
+#include "avenir/scene/ComponentInfo.hpp"
+
+namespace avenir::scene {
+
+/*
+ * Process-wide table of every component type's ComponentInfo, indexed by
+ * ComponentTypeId. A type is registered the first time the engine touches its
+ * storage, or up front with add<T>() so it can be found by name before any
+ * entity holds one (e.g. when loading a scene file). Lookups are lock-free and
+ * never allocate.
+ */
+class ComponentRegistry {
+public:
+    template <typename T>
+    static const ComponentInfo &add() {
+        return componentInfo<T>();
+    }
+
+    [[nodiscard]] static const ComponentInfo *find(ComponentTypeId id);
+    [[nodiscard]] static const ComponentInfo *find(std::string_view name);
+
+    // Calls function(const ComponentInfo &) for each registered type, in id
+    // order.
+    template <typename Function>
+    static void forEach(Function &&function) {
+        for (ComponentTypeId id = 0; id < kMaxComponentTypes; id++) {
+            if (const ComponentInfo *info = find(id)) {
+                function(*info);
+            }
+        }
+    }
+};
+
+}  // namespace avenir::scene
+
+#endif  // AVENIR_SCENE_COMPONENTREGISTRY_HPP
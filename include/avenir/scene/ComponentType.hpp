@@ -0,0 +1,50 @@
+#ifndef AVENIR_SCENE_COMPONENTTYPE_HPP
+#define AVENIR_SCENE_COMPONENTTYPE_HPP
+
+#include <atomic>
+#include <bitset>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+
+#include "avenir/scene/Component.hpp"
+
+namespace avenir::scene {
+
+using ComponentTypeId = uint32_t;
+
+static constexpr ComponentTypeId kMaxComponentTypes = 64;
+
+// One bit per component type; an archetype's signature.
+using ComponentMask = std::bitset<kMaxComponentTypes>;
+
+inline ComponentTypeId nextComponentTypeId() {
+    static std::atomic<ComponentTypeId> counter = 0;
+
+    const ComponentTypeId id = counter.fetch_add(1, std::memory_order_relaxed);
+    if (id >= kMaxComponentTypes) {
+        throw std::runtime_error(
+            "Error: Exceeded maximum number of component types!\n");
+    }
+
+    return id;
+}
+
+/*
+ * Dense, zero-based id for a component type, assigned the first time the type
+ * is used. Ids index straight into archetype column tables and signature
+ * masks, so lookups need neither RTTI nor hashing.
+ */
+template <typename T>
+ComponentTypeId componentTypeId() {
+    static_assert(std::is_base_of_v<Component, T>,
+                  "T must derive from Component");
+
+    static const ComponentTypeId id = nextComponentTypeId();
+
+    return id;
+}
+
+}  // namespace avenir::scene
+
+#endif  // AVENIR_SCENE_COMPONENTTYPE_HPP
@@ -0,0 +1,249 @@
+#ifndef AVENIR_SCENE_DYNAMICAABBTREE_HPP
+#define AVENIR_SCENE_DYNAMICAABBTREE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "avenir/scene/Bounds.hpp"
+
+namespace avenir::scene {
+
+/*
+ * Incremental bounding volume hierarchy over axis-aligned boxes. Each proxy is
+ * a leaf holding its exact bounds plus a fattened copy used for the tree
+ * itself, so small movements only need a containment check. A leaf that
+ * escapes its fat bounds is removed and reinserted.
+ *
+ * Insertion picks the sibling that minimises the total surface area added to
+ * the tree (a branch-and-bound search over the surface area heuristic), and
+ * every ancestor of a changed leaf is refitted and offered a tree rotation
+ * that shrinks it, which keeps the tree balanced without periodic rebuilds.
+ *
+ * Queries test internal nodes against the fat bounds and leaves against the
+ * exact ones, and report the user data given to createProxy(). They share
+ * scratch storage with the tree, so they must not run concurrently or from
+ * within another query's callback.
+ */
+class DynamicAabbTree {
+public:
+    static constexpr uint32_t kNullNode = std::numeric_limits<uint32_t>::max();
+
+    // Slack added around every leaf; a proxy moving less than this stays put.
+    explicit DynamicAabbTree(float margin = 0.1f);
+
+    // Returns the proxy id, which stays valid until destroyProxy().
+    uint32_t createProxy(const Aabb &bounds, uint32_t userData);
+    void destroyProxy(uint32_t proxy);
+    // Updates the exact bounds; returns whether the leaf had to be moved
+    // within the tree.
+    bool moveProxy(uint32_t proxy, const Aabb &bounds);
+
+    [[nodiscard]] uint32_t userData(uint32_t proxy) const;
+    [[nodiscard]] const Aabb &bounds(uint32_t proxy) const;
+    [[nodiscard]] const Aabb &fatBounds(uint32_t proxy) const;
+
+    [[nodiscard]] uint32_t proxyCount() const;
+    // Number of levels on the longest root-to-leaf path, 0 for an empty tree.
+    [[nodiscard]] uint32_t height() const;
+    // Sum of internal node surface areas over the root's; lower is better.
+    [[nodiscard]] float areaRatio() const;
+
+    // Calls function(userData) for every proxy overlapping `box`.
+    template <typename Function>
+    void queryOverlaps(const Aabb &box, Function &&function) const;
+
+    // Calls function(userData, distance) for every proxy the ray enters within
+    // maxDistance, nearer subtrees first. The callback returns the new maximum
+    // distance: its `distance` argument to keep only closer hits, maxDistance
+    // to see every hit, or 0 to stop.
+    template <typename Function>
+    void raycast(const Ray &ray, float maxDistance, Function &&function) const;
+
+    // Calls function(userData) for every proxy intersecting the frustum.
+    // Subtrees fully inside it are reported without further plane tests.
+    template <typename Function>
+    void queryFrustum(const Frustum &frustum, Function &&function) const;
+
+private:
+    struct Node {
+        // Fat bounds for leaves, the union of both children otherwise.
+        Aabb bounds;
+        // Next free node while the node is on the free list.
+        uint32_t parent = kNullNode;
+        uint32_t child1 = kNullNode;
+        uint32_t child2 = kNullNode;
+        uint32_t userData = 0;
+        uint32_t height = 0;
+
+        [[nodiscard]] bool isLeaf() const { return child1 == kNullNode; }
+    };
+
+    uint32_t allocateNode();
+    void freeNode(uint32_t node);
+
+    void insertLeaf(uint32_t leaf);
+    void removeLeaf(uint32_t leaf);
+    [[nodiscard]] uint32_t findBestSibling(const Aabb &bounds) const;
+    // Refits every node from `node` up to the root, rotating along the way.
+    void refitAncestors(uint32_t node);
+    void rotate(uint32_t node);
+
+    template <typename Function>
+    void reportSubtree(uint32_t node, Function &function) const;
+
+    float m_margin;
+    std::vector<Node> m_nodes;
+    // Exact bounds per leaf, indexed like m_nodes. Kept apart so tree walks
+    // only pull in the fat bounds.
+    std::vector<Aabb> m_leafBounds;
+    uint32_t m_root = kNullNode;
+    uint32_t m_freeList = kNullNode;
+    uint32_t m_proxyCount = 0;
+
+    // Traversal scratch, reused so queries do not allocate once warm.
+    mutable std::vector<uint32_t> m_stack;
+    mutable std::vector<std::pair<uint32_t, float>> m_costStack;
+};
+
+template <typename Function>
+void DynamicAabbTree::queryOverlaps(const Aabb &box,
+                                    Function &&function) const {
+    if (m_root == kNullNode) {
+        return;
+    }
+
+    m_stack.clear();
+    m_stack.emplace_back(m_root);
+    while (!m_stack.empty()) {
+        const uint32_t index = m_stack.back();
+        const Node &node = m_nodes[index];
+        m_stack.pop_back();
+
+        if (!node.bounds.overlaps(box)) {
+            continue;
+        }
+
+        if (node.isLeaf()) {
+            if (m_leafBounds[index].overlaps(box)) {
+                function(node.userData);
+            }
+        } else {
+            m_stack.emplace_back(node.child1);
+            m_stack.emplace_back(node.child2);
+        }
+    }
+}
+
+template <typename Function>
+void DynamicAabbTree::raycast(const Ray &ray, float maxDistance,
+                              Function &&function) const {
+    if (m_root == kNullNode) {
+        return;
+    }
+
+    // Entries carry the distance at which the ray entered the node, so nodes
+    // beyond a shortened maxDistance are dropped when they are popped.
+    m_costStack.clear();
+    if (const auto entry = ray.intersect(m_nodes[m_root].bounds, maxDistance)) {
+        m_costStack.emplace_back(m_root, *entry);
+    }
+
+    while (!m_costStack.empty()) {
+        const auto [index, entry] = m_costStack.back();
+        m_costStack.pop_back();
+        if (entry > maxDistance) {
+            continue;
+        }
+
+        const Node &node = m_nodes[index];
+        if (node.isLeaf()) {
+            if (const auto hit = ray.intersect(m_leafBounds[index], maxDistance)) {
+                maxDistance = function(node.userData, *hit);
+                if (maxDistance <= 0.0f) {
+                    return;
+                }
+            }
+            continue;
+        }
+
+        const auto entry1 = ray.intersect(m_nodes[node.child1].bounds,
+                                          maxDistance);
+        const auto entry2 = ray.intersect(m_nodes[node.child2].bounds,
+                                          maxDistance);
+
+        // Push the farther child first so the nearer one is visited first.
+        if (entry1 && entry2 && *entry1 < *entry2) {
+            m_costStack.emplace_back(node.child2, *entry2);
+            m_costStack.emplace_back(node.child1, *entry1);
+        } else {
+            if (entry1) {
+                m_costStack.emplace_back(node.child1, *entry1);
+            }
+            if (entry2) {
+                m_costStack.emplace_back(node.child2, *entry2);
+            }
+        }
+    }
+}
+
+template <typename Function>
+void DynamicAabbTree::queryFrustum(const Frustum &frustum,
+                                   Function &&function) const {
+    if (m_root == kNullNode) {
+        return;
+    }
+
+    m_stack.clear();
+    m_stack.emplace_back(m_root);
+    while (!m_stack.empty()) {
+        const uint32_t index = m_stack.back();
+        const Node &node = m_nodes[index];
+        m_stack.pop_back();
+
+        if (node.isLeaf()) {
+            if (frustum.intersects(m_leafBounds[index])) {
+                function(node.userData);
+            }
+            continue;
+        }
+
+        switch (frustum.classify(node.bounds)) {
+            case Frustum::Containment::eOutside:
+                break;
+            case Frustum::Containment::eInside:
+                reportSubtree(index, function);
+                break;
+            case Frustum::Containment::eIntersecting:
+                m_stack.emplace_back(node.child1);
+                m_stack.emplace_back(node.child2);
+                break;
+        }
+    }
+}
+
+template <typename Function>
+void DynamicAabbTree::reportSubtree(const uint32_t node,
+                                    Function &function) const {
+    // Shares m_stack with the caller: everything pushed here is popped again
+    // before returning.
+    const std::size_t base = m_stack.size();
+    m_stack.emplace_back(node);
+    while (m_stack.size() > base) {
+        const Node &current = m_nodes[m_stack.back()];
+        m_stack.pop_back();
+
+        if (current.isLeaf()) {
+            function(current.userData);
+        } else {
+            m_stack.emplace_back(current.child1);
+            m_stack.emplace_back(current.child2);
+        }
+    }
+}
+
+}  // namespace avenir::scene
+
+#endif  // AVENIR_SCENE_DYNAMICAABBTREE_HPP
@@ -0,0 +1,24 @@
+#ifndef AVENIR_SCENE_ENTITYID_HPP
+#define AVENIR_SCENE_ENTITYID_HPP
+
+#include <compare>
+#include <cstdint>
+
+namespace avenir::scene {
+
+/*
+ * Generational entity handle. `index` addresses a slot in the owning scene and
+ * is recycled once the entity is destroyed; `generation` is bumped on every
+ * reuse so stale handles to a recycled slot fail validation instead of
+ * silently aliasing the new occupant.
+ */
+struct EntityId {
+    uint32_t index = 0;
+    uint32_t generation = 0;
+
+    auto operator<=>(const EntityId &) const = default;
+};
+
+}  // namespace avenir::scene
+
+#endif  // AVENIR_SCENE_ENTITYID_HPP
@@ -0,0 +1,100 @@
+#ifndef AVENIR_SCENE_FRUSTUMCULLER_HPP
+#define AVENIR_SCENE_FRUSTUMCULLER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <glm/mat4x4.hpp>
+
+#include "avenir/graphics/MeshHandle.hpp"
+#include "avenir/scene/Bounds.hpp"
+#include "avenir/scene/EntityId.hpp"
+
+namespace avenir::scene {
+
+class Scene;
+
+// Structure-of-arrays view over a batch of world-space bounds: a bounding
+// sphere and an AABB sharing the same center, one float stream per scalar,
+// all of the same length.
+struct CullingBoundsArrays {
+    std::span<const float> centerX;
+    std::span<const float> centerY;
+    std::span<const float> centerZ;
+    std::span<const float> radius;
+    std::span<const float> extentX;
+    std::span<const float> extentY;
+    std::span<const float> extentZ;
+};
+
+/*
+ * Per-frame visibility of MeshRenderer entities for one camera. cull()
+ * gathers the world bounds of every MeshRenderer entity into SoA streams,
+ * builds the frustum from the camera's Camera component and world matrix,
+ * and leaves a compact, ascending list of the visible ones for the renderer.
+ * gather() does the same up to the culling, for renderers that test the
+ * gathered bounds on the GPU instead.
+ *
+ * Storage is reused between frames, so a steady scene culls without
+ * allocating.
+ */
+class FrustumCuller {
+public:
+    // Throws if `camera` has no Camera component.
+    void cull(Scene &scene, EntityId camera, float aspectRatio);
+    // Like cull(), but leaves visibleIndices() empty. Throws if `camera` has
+    // no Camera component.
+    void gather(Scene &scene, EntityId camera, float aspectRatio);
+
+    [[nodiscard]] const glm::mat4 &viewMatrix() const;
+    [[nodiscard]] const glm::mat4 &projectionMatrix() const;
+    [[nodiscard]] const Frustum &frustum() const;
+
+    // Every MeshRenderer entity gathered by the last cull(), in scene storage
+    // order.
+    [[nodiscard]] std::span<const EntityId> entities() const;
+    // Mesh handle and world matrix of each of entities(), at the same index.
+    [[nodiscard]] std::span<const graphics::MeshHandle> meshes() const;
+    [[nodiscard]] std::span<const glm::mat4> worldMatrices() const;
+    // World-space bounds of each of entities(), at the same index.
+    [[nodiscard]] CullingBoundsArrays bounds() const;
+    // Positions in entities() of those inside the frustum.
+    [[nodiscard]] std::span<const uint32_t> visibleIndices() const;
+
+    // Writes the index of every element of `bounds` inside the frustum to
+    // `visible`, which must hold one slot per element, and returns how many
+    // were written. Each batch is first tested by sphere and only batches
+    // with a surviving sphere get the tighter AABB test. Uses AVX2 or SSE
+    // where available, eight or four elements at a time, and a scalar loop
+    // for the remainder or on other architectures.
+    static std::size_t cullBounds(const Frustum &frustum,
+                                  const CullingBoundsArrays &bounds,
+                                  std::span<uint32_t> visible);
+
+private:
+    void gatherEntities(Scene &scene);
+
+    glm::mat4 m_viewMatrix = glm::mat4(1.0f);
+    glm::mat4 m_projectionMatrix = glm::mat4(1.0f);
+    Frustum m_frustum{};
+
+    std::vector<EntityId> m_entities;
+    std::vector<graphics::MeshHandle> m_meshes;
+    std::vector<glm::mat4> m_worldMatrices;
+    std::vector<float> m_centerX;
+    std::vector<float> m_centerY;
+    std::vector<float> m_centerZ;
+    std::vector<float> m_radius;
+    std::vector<float> m_extentX;
+    std::vector<float> m_extentY;
+    std::vector<float> m_extentZ;
+
+    std::vector<uint32_t> m_visible;
+    std::size_t m_visibleCount = 0;
+};
+
+}  // namespace avenir::scene
+
+#endif  // AVENIR_SCENE_FRUSTUMCULLER_HPP
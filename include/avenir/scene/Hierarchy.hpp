@@ -0,0 +1,81 @@
+#ifndef AVENIR_SCENE_HIERARCHY_HPP
+#define AVENIR_SCENE_HIERARCHY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+
+#include "avenir/scene/EntityId.hpp"
+
+namespace avenir::scene {
+
+class Scene;
+
+// Marks an absent parent, child or sibling in HierarchyLinks.
+static constexpr uint32_t kNoEntity = std::numeric_limits<uint32_t>::max();
+
+/*
+ * Parent/child links of one entity slot, stored as indices into the scene's
+ * entity table. Children form a doubly linked sibling list, so attaching and
+ * detaching are O(1) and never allocate, and walking a subtree only touches
+ * this flat array.
+ */
+struct HierarchyLinks {
+    uint32_t parent = kNoEntity;
+    uint32_t firstChild = kNoEntity;
+    uint32_t lastChild = kNoEntity;
+    uint32_t previousSibling = kNoEntity;
+    uint32_t nextSibling = kNoEntity;
+    uint32_t childCount = 0;
+};
+
+/*
+ * An entity's children in the order they were attached. Like a View, it reads
+ * the scene's links directly and is invalidated by reparenting or destroying
+ * any of the children.
+ */
+class ChildRange {
+public:
+    class Iterator {
+    public:
+        using value_type = EntityId;
+        using difference_type = std::ptrdiff_t;
+
+        Iterator() = default;
+        Iterator(const Scene &scene, uint32_t index)
+            : m_scene(&scene), m_index(index) {}
+
+        EntityId operator*() const;
+        Iterator &operator++();
+        Iterator operator++(int);
+
+        bool operator==(const Iterator &other) const {
+            return m_index == other.m_index;
+        }
+
+    private:
+        const Scene *m_scene = nullptr;
+        uint32_t m_index = kNoEntity;
+    };
+
+    ChildRange(const Scene &scene, const HierarchyLinks &links)
+        : m_scene(&scene), m_first(links.firstChild), m_size(links.childCount) {}
+
+    [[nodiscard]] Iterator begin() const { return {*m_scene, m_first}; }
+    [[nodiscard]] Iterator end() const { return {*m_scene, kNoEntity}; }
+
+    [[nodiscard]] std::size_t size() const { return m_size; }
+    [[nodiscard]] bool empty() const { return m_size == 0; }
+
+private:
+    const Scene *m_scene;
+    uint32_t m_first;
+    uint32_t m_size;
+};
+
+static_assert(std::forward_iterator<ChildRange::Iterator>);
+
+}  // namespace avenir::scene
+
+#endif  // AVENIR_SCENE_HIERARCHY_HPP
@@ -1,34 +1,581 @@
 #ifndef AVENIR_SCENE_SCENE_HPP
 #define AVENIR_SCENE_SCENE_HPP
 
+#include <array>
+#include <memory>
+#include <shared_mutex>
+#include <span>
+#include <sstream>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
 #include <unordered_map>
+#include <utility>
 
 #include <glm/mat4x4.hpp>
 
+#include "avenir/scene/Archetype.hpp"
+#include "avenir/scene/Bounds.hpp"
+#include "avenir/scene/DynamicAabbTree.hpp"
 #include "avenir/scene/Entity.hpp"
+#include "avenir/scene/Hierarchy.hpp"
+#include "avenir/scene/SceneCommandBuffer.hpp"
+#include "avenir/scene/SceneSnapshot.hpp"
+#include "avenir/scene/View.hpp"
+#include "avenir/scene/components/Transform.hpp"
+#include "avenir/scene/components/WorldTransform.hpp"
+
+namespace avenir::jobs {
+class JobSystem;
+}  // namespace avenir::jobs
 
 namespace avenir::scene {
 
 class Scene {
 public:
+    // Threaded passes use jobs::JobSystem::shared().
     Scene() = default;
+    explicit Scene(jobs::JobSystem &jobSystem);
     ~Scene() = default;
 
-    Entity &createEntity();
-    std::optional<Entity *> findEntityById(uint32_t id);
+    // Entity handles point back at their scene, so scenes stay put.
+    Scene(const Scene &) = delete;
+    Scene &operator=(const Scene &) = delete;
+
+    Entity createEntity();
+    std::optional<Entity> findEntityById(EntityId id);
+
+    // Creates `count` copies of the hierarchy rooted at `prefab` and returns
+    // the new roots, which are left unparented. Rows are copied a column at a
+    // time into contiguous storage and parent/child links are remapped in
+    // bulk, without a per-entity archetype lookup or virtual call. Each root
+    // takes its Transform from `rootTransforms` when one is given per copy.
+    // Every component of the prefab must be copy constructible.
+    std::vector<EntityId> instantiate(
+        EntityId prefab, uint32_t count,
+        std::span<const components::Transform> rootTransforms = {});
+
+    // Destroys the entity and its components and recycles its id. Children
+    // are detached and become roots rather than being destroyed.
+    void destroyEntity(EntityId id);
+    // Like destroyEntity, but ids that are already stale are skipped.
+    void destroyEntities(std::span<const EntityId> ids);
+    [[nodiscard]] bool isValid(EntityId id) const;
+
+    void setEntityParent(EntityId child, std::optional<EntityId> parent);
+    void detachEntityFromParent(EntityId child);
+
+    [[nodiscard]] std::optional<EntityId> entityParent(EntityId id) const;
+    [[nodiscard]] ChildRange entityChildren(EntityId id) const;
+
+    template <typename T>
+    [[nodiscard]] bool hasComponent(EntityId id) const {
+        return entityRecord(id).archetype->mask().test(componentTypeId<T>());
+    }
+
+    template <typename T, typename... Args>
+    T &addComponent(EntityId id, Args &&...args) {
+        const ComponentInfo &info = componentInfo<T>();
+        if (hasComponent<T>(id)) {
+            std::ostringstream errorMessage;
+            errorMessage << "Error: Entity already has component of type: "
+                         << T::staticName;
+
+            throw std::runtime_error(errorMessage.str());
+        }
+
+        // Construct up front so a throwing constructor leaves storage intact.
+        T value(std::forward<Args>(args)...);
+
+        return *std::construct_at(static_cast<T *>(insertComponent(id, info)),
+                                  std::move(value));
+    }
+
+    template <typename T>
+    void removeComponent(EntityId id) {
+        static_assert(!std::is_same_v<T, components::Transform> &&
+                          !std::is_same_v<T, components::WorldTransform>,
+                      "Every entity keeps its Transform and WorldTransform");
+
+        if (!hasComponent<T>(id)) {
+            throw std::runtime_error(
+                "Entity does not have requested component!\n");
+        }
+
+        eraseComponent(id, componentInfo<T>());
+    }
+
+    // Mutable access to a Transform marks the entity's world matrix dirty.
+    template <typename T>
+    T &component(EntityId id) {
+        T &result = *static_cast<T *>(componentPointer(id, componentInfo<T>()));
+        if constexpr (std::is_same_v<T, components::Transform>) {
+            markTransformDirty(id);
+        }
+
+        return result;
+    }
+
+    template <typename T>
+    const T &component(EntityId id) const {
+        return *static_cast<const T *>(
+            componentPointer(id, componentInfo<T>()));
+    }
+
+    void listComponents(EntityId id) const;
+
+    // Applies and consumes the commands recorded in every buffer as one
+    // batch. See SceneCommandBuffer for ordering rules.
+    void applyCommands(std::span<SceneCommandBuffer *const> buffers);
+    void applyCommands(SceneCommandBuffer &buffer);
+
+    template <typename... Ts>
+    [[nodiscard]] View<Ts...> view() {
+        return View<Ts...>(*this, m_changeTick);
+    }
+
+    // Calls function(Ts &...) or function(Entity, Ts &...) for every entity
+    // holding all of Ts, walking matching archetypes chunk by chunk. Changed<>
+    // terms match components written during the current tick.
+    template <typename... Ts, typename Function>
+    void each(Function &&function) {
+        eachSince<Ts...>(m_changeTick, std::forward<Function>(function));
+    }
 
-    void setEntityParent(uint32_t child, std::optional<uint32_t> parent);
-    void detachEntityFromParent(uint32_t child);
+    template <typename... Ts>
+    [[nodiscard]] std::size_t count() {
+        return countSince<Ts...>(m_changeTick);
+    }
 
-    glm::mat4 entityWorldMatrix(uint32_t id);
-    glm::mat4 entityInverseWorldMatrix(uint32_t id);
+    // Writes through component<T>(), each() and views are stamped with this
+    // tick. A consumer remembers the tick it last ran at and later asks for
+    // View<Changed<T>>::since() that tick to see only what was modified.
+    [[nodiscard]] uint32_t changeTick() const;
+    // Starts a new tick; SystemScheduler calls this once per frame. Must not
+    // run concurrently with systems.
+    uint32_t advanceChangeTick();
+
+    // Captures every component as it is now, typically for the renderer to
+    // read while the next frame simulates. World transforms are flushed
+    // first. Chunks are shared rather than copied; the scene copies one only
+    // when it next writes to it. Throws if a populated archetype holds a
+    // component that is not copy constructible. Must not run concurrently
+    // with systems.
+    [[nodiscard]] SceneSnapshot snapshot();
+    // As snapshot(), releasing the previous contents of `snapshot` and
+    // reusing its storage.
+    void captureSnapshot(SceneSnapshot &snapshot);
+
+    [[nodiscard]] const std::vector<std::unique_ptr<Archetype>> &archetypes()
+        const;
+
+    // Chunk pool counters; heapAllocations stops growing once the scene has
+    // reached its working size.
+    [[nodiscard]] const AllocationStats &allocationStats() const;
+
+    // Flags the entity's cached world matrix (and its descendants') for
+    // recomputation. Needed only when a Transform is written through raw
+    // archetype storage rather than component<Transform>().
+    void markTransformDirty(EntityId id);
+
+    // Recomputes the world matrix of every dirty entity and its descendants.
+    // Affected entities are flagged level by level, their local matrices are
+    // then built chunk by chunk with Transform::localMatrices(), and a final
+    // level-by-level pass composes them with their parents'. Once a scene is
+    // large enough each pass is split across the scene's job system; every
+    // parent is finished before its children's level starts. When only a
+    // small part of the scene is dirty, the dirty subtrees are walked and
+    // rebuilt directly instead.
+    void updateWorldTransforms();
+
+    // Cached lookups; a pending update is flushed first if anything changed.
+    glm::mat4 entityWorldMatrix(EntityId id);
+    glm::mat4 entityInverseWorldMatrix(EntityId id);
+
+    // The first entity whose Camera is marked primary, if any.
+    [[nodiscard]] std::optional<EntityId> primaryCamera();
+
+    // Brings the spatial index over MeshRenderer entities up to date: world
+    // transforms are flushed first, then every entity whose WorldTransform or
+    // MeshRenderer was written since the previous update is refitted.
+    void updateSpatialIndex();
+    [[nodiscard]] const DynamicAabbTree &spatialIndex() const;
+
+    // The spatial queries below update the index first whenever a transform
+    // has moved or the change tick has advanced since it was last updated.
+    // MeshRenderer bounds edited within the current tick are only seen after
+    // an explicit updateSpatialIndex().
+
+    // Calls function(EntityId) for every MeshRenderer entity whose world
+    // bounds overlap `box`.
+    template <typename Function>
+    void queryOverlaps(const Aabb &box, Function &&function) {
+        refreshSpatialIndex();
+        m_spatialIndex.queryOverlaps(box, [&](const uint32_t index) {
+            function(EntityId{index, m_entities[index].generation});
+        });
+    }
+
+    // Calls function(EntityId, distance) for every MeshRenderer entity whose
+    // world bounds the ray enters; see DynamicAabbTree::raycast() for what the
+    // callback returns.
+    template <typename Function>
+    void raycast(const Ray &ray, const float maxDistance, Function &&function) {
+        refreshSpatialIndex();
+        m_spatialIndex.raycast(
+            ray, maxDistance, [&](const uint32_t index, const float distance) {
+                return function(EntityId{index, m_entities[index].generation},
+                                distance);
+            });
+    }
+
+    // Calls function(EntityId) for every MeshRenderer entity whose world
+    // bounds intersect the frustum.
+    template <typename Function>
+    void queryFrustum(const Frustum &frustum, Function &&function) {
+        refreshSpatialIndex();
+        m_spatialIndex.queryFrustum(frustum, [&](const uint32_t index) {
+            function(EntityId{index, m_entities[index].generation});
+        });
+    }
 
     void printEntityIds();
 
 private:
-    std::unordered_map<uint32_t, Entity> m_entities;
+    template <typename...>
+    friend class View;
+    friend class ChildRange::Iterator;
+
+    // One slot per entity index. A slot is free while `archetype` is null;
+    // its generation is bumped when it is released so old handles go stale.
+    struct EntityRecord {
+        Archetype *archetype = nullptr;
+        uint32_t row = 0;
+        uint32_t generation = 0;
+        // Set while the entity is queued in m_dirtyTransforms.
+        bool worldTransformDirty = false;
+        // Whether the last update pass rebuilt this entity's world matrix;
+        // read by its children during the same pass.
+        bool worldTransformChanged = false;
+        uint32_t spatialProxy = DynamicAabbTree::kNullNode;
+    };
+
+    [[nodiscard]] EntityRecord &entityRecord(EntityId id);
+    [[nodiscard]] const EntityRecord &entityRecord(EntityId id) const;
+
+    // Unchecked access for records already known to hold a T.
+    template <typename T>
+    T &recordComponent(const EntityRecord &record) {
+        return *static_cast<T *>(record.archetype->componentAt(
+            *record.archetype->columnIndex(componentInfo<T>()), record.row));
+    }
+
+    // Read-only; does not unshare the chunk from snapshots.
+    template <typename T>
+    const T &recordComponent(const EntityRecord &record) const {
+        const Archetype &archetype = *record.archetype;
+
+        return *static_cast<const T *>(archetype.componentAt(
+            *archetype.columnIndex(componentInfo<T>()), record.row));
+    }
+
+    template <typename... Ts>
+    static ComponentMask componentMask() {
+        ComponentMask mask;
+        (mask.set(componentTypeId<Ts>()), ...);
+
+        return mask;
+    }
+
+    // Column pointer for one query term. Only mutable terms unshare the chunk
+    // from snapshots.
+    template <typename Term>
+    static auto termData(Archetype &archetype, const std::size_t chunk) {
+        using Component = typename QueryTerm<Term>::Component;
+        if constexpr (QueryTerm<Term>::isMutable) {
+            return archetype.components<Component>(chunk).data();
+        } else {
+            return std::as_const(archetype).components<Component>(chunk).data();
+        }
+    }
+
+    template <typename... Ts, typename Function>
+    void eachSince(const uint32_t since, Function &&function) {
+        static_assert(sizeof...(Ts) > 0, "each() needs at least one type");
+
+        constexpr std::size_t termCount = sizeof...(Ts);
+        constexpr std::array<bool, termCount> changedTerms = {
+            QueryTerm<Ts>::isChanged...};
+        constexpr std::array<bool, termCount> mutableTerms = {
+            QueryTerm<Ts>::isMutable...};
+        constexpr bool filtersChanges = (QueryTerm<Ts>::isChanged || ...);
+        constexpr bool writesTransform =
+            ((QueryTerm<Ts>::isMutable &&
+              std::is_same_v<typename QueryTerm<Ts>::Component,
+                             components::Transform>) ||
+             ...);
+
+        for (Archetype *archetype : matchingArchetypes(
+                 componentMask<typename QueryTerm<Ts>::Component...>())) {
+            const std::array<std::size_t, termCount> columns = {
+                *archetype->columnIndex(
+                    componentInfo<typename QueryTerm<Ts>::Component>())...};
+
+            for (std::size_t chunk = 0; chunk < archetype->chunkCount();
+                 chunk++) {
+                bool skipChunk = false;
+                std::array<std::span<const uint32_t>, termCount> ticks;
+                for (std::size_t term = 0; term < termCount; term++) {
+                    if (changedTerms[term]) {
+                        // A chunk with no recent write to the column can be
+                        // skipped without touching its rows.
+                        skipChunk |= archetype->chunkChangeTick(
+                                         chunk, columns[term]) < since;
+                        ticks[term] =
+                            archetype->changeTicks(chunk, columns[term]);
+                    } else if (mutableTerms[term] && !filtersChanges) {
+                        archetype->markChunkChanged(chunk, columns[term],
+                                                    m_changeTick);
+                    }
+                }
+
+                if (skipChunk) {
+                    continue;
+                }
+
+                const std::span<const uint32_t> entities =
+                    archetype->entities(chunk);
+                const auto data =
+                    std::make_tuple(termData<Ts>(*archetype, chunk)...);
+                const uint32_t firstRow =
+                    static_cast<uint32_t>(chunk) * archetype->chunkCapacity();
+
+                for (uint32_t i = 0; i < entities.size(); i++) {
+                    if constexpr (filtersChanges) {
+                        bool matches = true;
+                        for (std::size_t term = 0; term < termCount; term++) {
+                            matches &=
+                                !changedTerms[term] || ticks[term][i] >= since;
+                        }
+
+                        if (!matches) {
+                            continue;
+                        }
+
+                        for (std::size_t term = 0; term < termCount; term++) {
+                            if (mutableTerms[term]) {
+                                archetype->setChangeTick(
+                                    columns[term], firstRow + i, m_changeTick);
+                            }
+                        }
+                    }
+
+                    const EntityRecord &record = m_entities[entities[i]];
+                    if constexpr (writesTransform) {
+                        queueTransformUpdate(entities[i]);
+                    }
+
+                    std::apply(
+                        [&](auto *...components) {
+                            if constexpr (std::is_invocable_v<
+                                              Function, Entity,
+                                              typename QueryTerm<
+                                                  Ts>::Reference...>) {
+                                function(Entity(*this,
+                                                EntityId{entities[i],
+                                                         record.generation}),
+                                         components[i]...);
+                            } else {
+                                function(components[i]...);
+                            }
+                        },
+                        data);
+                }
+            }
+        }
+    }
+
+    template <typename... Ts>
+    [[nodiscard]] std::size_t countSince(const uint32_t since) {
+        constexpr std::size_t termCount = sizeof...(Ts);
+        constexpr std::array<bool, termCount> changedTerms = {
+            QueryTerm<Ts>::isChanged...};
+
+        std::size_t total = 0;
+        for (const Archetype *archetype : matchingArchetypes(
+                 componentMask<typename QueryTerm<Ts>::Component...>())) {
+            if constexpr (!(QueryTerm<Ts>::isChanged || ...)) {
+                total += archetype->size();
+                continue;
+            }
+
+            const std::array<std::size_t, termCount> columns = {
+                *archetype->columnIndex(
+                    componentInfo<typename QueryTerm<Ts>::Component>())...};
+
+            for (std::size_t chunk = 0; chunk < archetype->chunkCount();
+                 chunk++) {
+                for (uint32_t i = 0; i < archetype->chunkSize(chunk); i++) {
+                    bool matches = true;
+                    for (std::size_t term = 0; term < termCount; term++) {
+                        matches &= !changedTerms[term] ||
+                                   archetype->changeTicks(
+                                       chunk, columns[term])[i] >= since;
+                    }
+
+                    total += matches;
+                }
+            }
+        }
+
+        return total;
+    }
+
+    // Archetypes holding every component in `mask`, cached per mask and
+    // topped up with archetypes created since the last call. Safe to call
+    // from concurrently running systems.
+    const std::vector<Archetype *> &matchingArchetypes(
+        const ComponentMask &mask);
+
+    void *componentPointer(EntityId id, const ComponentInfo &info);
+    const void *componentPointer(EntityId id, const ComponentInfo &info) const;
+
+    // Appends `child` to the end of `parent`'s children.
+    void linkToParent(uint32_t child, uint32_t parent);
+    void unlinkFromParent(uint32_t index);
+    // Walks `index`'s parent chain, so costs O(depth).
+    [[nodiscard]] bool isAncestor(uint32_t ancestor, uint32_t index) const;
+
+    void rebuildHierarchyOrder();
+    // Runs updateSpatialIndex() only if something may have moved.
+    void refreshSpatialIndex();
+    void destroySpatialProxy(EntityRecord &record);
+    // Queues the entity for the next world transform pass, at most once.
+    void queueTransformUpdate(const uint32_t index) {
+        EntityRecord &record = m_entities[index];
+        if (!record.worldTransformDirty) {
+            record.worldTransformDirty = true;
+            m_dirtyTransforms.emplace_back(index);
+        }
+    }
+
+    // Rebuilds just the dirty subtrees, or returns false without changing
+    // anything when they hold too much of the scene for that to pay off.
+    bool updateDirtySubtrees();
+    void updateDirtyTransform(uint32_t index);
+    // The three passes over the whole scene; see updateWorldTransforms().
+    void updateAllWorldTransforms();
+    void flagWorldTransformChange(uint32_t index);
+    void updateLocalMatrices(Archetype &archetype, std::size_t chunk);
+    void updateWorldTransform(uint32_t index);
+
+    Archetype &archetype(std::vector<const ComponentInfo *> components);
+    Archetype &archetypeWithComponent(Archetype &source,
+                                      const ComponentInfo &info);
+    Archetype &archetypeWithoutComponent(Archetype &source,
+                                         const ComponentInfo &info);
+
+    // Moves the entity to the archetype with `info` added and returns the
+    // new, uninitialised component slot.
+    void *insertComponent(EntityId id, const ComponentInfo &info);
+    void eraseComponent(EntityId id, const ComponentInfo &info);
+
+    // Relocates the entity's row, returning where its components now live.
+    std::pair<Archetype *, uint32_t> moveEntityToArchetype(
+        EntityId id, Archetype &destination);
+
+    // Null until set, meaning jobs::JobSystem::shared(), which is only
+    // created once a pass first needs it.
+    jobs::JobSystem *m_jobSystem = nullptr;
+
+    std::vector<EntityRecord> m_entities;
+    // Parallel to m_entities.
+    std::vector<HierarchyLinks> m_hierarchy;
+    std::vector<uint32_t> m_freeIndices;
+
+    // Entities whose world matrix is stale, each queued once.
+    std::vector<uint32_t> m_dirtyTransforms;
+    // Entities rebuilt by updateDirtySubtrees(), parents before children.
+    std::vector<uint32_t> m_dirtySubtrees;
+    // Starts at 1 so freshly created components count as changed for a
+    // consumer that has never run (since == 0).
+    uint32_t m_changeTick = 1;
+
+    // Live entity indices in breadth-first order; level i spans
+    // [m_hierarchyLevelOffsets[i], m_hierarchyLevelOffsets[i + 1]).
+    std::vector<uint32_t> m_hierarchyOrder;
+    std::vector<uint32_t> m_hierarchyLevelOffsets;
+    bool m_hierarchyOrderDirty = true;
+    // Every (archetype, chunk) holding transforms; rebuilt by each pass.
+    std::vector<std::pair<Archetype *, std::size_t>> m_transformChunks;
+
+    // Leaves carry entity slot indices.
+    DynamicAabbTree m_spatialIndex;
+    uint32_t m_spatialIndexTick = 0;
+    // Set by every world transform pass that did work.
+    bool m_spatialIndexDirty = true;
+
+    // Declared before the archetypes so it outlives their chunks.
+    ChunkAllocator m_chunkAllocator;
+    std::vector<std::unique_ptr<Archetype>> m_archetypes;
+    std::unordered_map<ComponentMask, Archetype *> m_archetypesBySignature;
+
+    struct QueryCache {
+        std::vector<Archetype *> archetypes;
+        std::size_t checkedArchetypes = 0;
+    };
+
+    // Systems run by SystemScheduler query concurrently. Lookups share the
+    // lock; inserting a mask or topping up a cache takes it exclusively.
+    std::unordered_map<ComponentMask, QueryCache> m_queries;
+    std::shared_mutex m_queriesMutex;
+
+    struct QueuedCommand {
+        SceneCommandBuffer::Command *command;
+        EntityId target;
+        std::optional<EntityId> parent;
+        uint32_t sequence;
+    };
+
+    std::vector<QueuedCommand> m_commandQueue;
 };
 
+template <typename... Ts>
+template <typename Function>
+void View<Ts...>::each(Function &&function) const {
+    m_scene->eachSince<Ts...>(m_since, std::forward<Function>(function));
+}
+
+template <typename... Ts>
+std::size_t View<Ts...>::size() const {
+    return m_scene->countSince<Ts...>(m_since);
+}
+
+template <typename T>
+bool Entity::hasComponent() const {
+    return m_scene->hasComponent<T>(m_id);
+}
+
+template <typename T, typename... Args>
+T &Entity::addComponent(Args &&...args) {
+    return m_scene->addComponent<T>(m_id, std::forward<Args>(args)...);
+}
+
+template <typename T>
+void Entity::removeComponent() {
+    m_scene->removeComponent<T>(m_id);
+}
+
+template <typename T>
+T &Entity::component() {
+    return m_scene->component<T>(m_id);
+}
+
+template <typename T>
+const T &Entity::component() const {
+    return std::as_const(*m_scene).template component<T>(m_id);
+}
+
 }  // namespace avenir::scene
 
 #endif  // AVENIR_SCENE_SCENE_HPP
@@ -0,0 +1,129 @@
+#ifndef AVENIR_SCENE_SCENECOMMANDBUFFER_HPP
+#define AVENIR_SCENE_SCENECOMMANDBUFFER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "avenir/scene/ComponentInfo.hpp"
+#include "avenir/scene/EntityId.hpp"
+#include "avenir/scene/components/Transform.hpp"
+#include "avenir/scene/components/WorldTransform.hpp"
+
+namespace avenir::scene {
+
+/*
+ * Records structural scene edits (entity creation and destruction, component
+ * adds and removes, reparenting) so they can be made from systems running
+ * concurrently. Use one buffer per thread; a buffer itself is not
+ * thread-safe. Scene::applyCommands() merges any number of buffers and applies
+ * them in one batch at a sync point, grouped by kind of edit and component
+ * type so entities move between the same archetypes back to back.
+ *
+ * Within a batch, creations run first, then component adds/removes, then
+ * reparenting, then destruction. Commands aimed at entities that are no
+ * longer valid are dropped, as are reparents that would form a cycle, and a
+ * deferred add of a component the entity already has replaces its value.
+ */
+class SceneCommandBuffer {
+public:
+    // An entity this buffer will create; resolved by Scene::applyCommands().
+    struct PendingEntity {
+        uint32_t index;
+    };
+
+    // Either an existing entity or one pending creation in this buffer.
+    struct Target {
+        Target(EntityId id) : id(id) {}
+        Target(PendingEntity pending)
+            : id{pending.index, 0}, isPending(true) {}
+
+        EntityId id;
+        bool isPending = false;
+    };
+
+    SceneCommandBuffer() = default;
+    ~SceneCommandBuffer();
+
+    SceneCommandBuffer(const SceneCommandBuffer &) = delete;
+    SceneCommandBuffer &operator=(const SceneCommandBuffer &) = delete;
+
+    PendingEntity createEntity();
+    void destroyEntity(EntityId id);
+
+    template <typename T, typename... Args>
+    void addComponent(Target target, Args &&...args) {
+        const ComponentInfo &info = componentInfo<T>();
+        void *value = allocateValue(info.size, info.alignment);
+        std::construct_at(static_cast<T *>(value), std::forward<Args>(args)...);
+
+        m_commands.push_back(
+            {CommandType::eAddComponent, target, std::nullopt, &info, value});
+    }
+
+    template <typename T>
+    void removeComponent(Target target) {
+        static_assert(!std::is_same_v<T, components::Transform> &&
+                          !std::is_same_v<T, components::WorldTransform>,
+                      "Every entity keeps its Transform and WorldTransform");
+
+        m_commands.push_back({CommandType::eRemoveComponent, target,
+                              std::nullopt, &componentInfo<T>(), nullptr});
+    }
+
+    // Throws if `parent` is `child` itself.
+    void setEntityParent(Target child, std::optional<Target> parent);
+
+    [[nodiscard]] bool empty() const;
+
+    // Id assigned to a pending entity by the most recent apply.
+    [[nodiscard]] EntityId entity(PendingEntity pending) const;
+
+    // Drops every recorded command and destroys pending component values.
+    // Memory is kept for reuse.
+    void clear();
+
+private:
+    friend class Scene;
+
+    enum class CommandType : uint8_t {
+        eAddComponent,
+        eRemoveComponent,
+        eSetParent,
+        eDestroy
+    };
+
+    struct Command {
+        CommandType type;
+        Target target;
+        std::optional<Target> parent;
+        const ComponentInfo *component;
+        // Component value for eAddComponent; null once moved into the scene.
+        void *value;
+    };
+
+    static constexpr std::size_t kPageSize = 4096;
+
+    struct Page {
+        std::unique_ptr<std::byte[]> memory;
+        std::size_t size;
+    };
+
+    void *allocateValue(std::size_t size, std::size_t alignment);
+
+    std::vector<Command> m_commands;
+    uint32_t m_pendingCount = 0;
+    std::vector<EntityId> m_created;
+
+    std::vector<Page> m_pages;
+    std::size_t m_currentPage = 0;
+    std::size_t m_pageOffset = 0;
+};
+
+}  // namespace avenir::scene
+
+#endif  // AVENIR_SCENE_SCENECOMMANDBUFFER_HPP
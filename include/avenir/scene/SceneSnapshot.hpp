@@ -0,0 +1,179 @@
+#ifndef AVENIR_SCENE_SCENESNAPSHOT_HPP
+#define AVENIR_SCENE_SCENESNAPSHOT_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "avenir/scene/Archetype.hpp"
+#include "avenir/scene/EntityId.hpp"
+
+namespace avenir::scene {
+
+/*
+ * Read-only view of every component of a Scene as it was at one point in
+ * time, for the renderer to draw frame N while frame N + 1 simulates.
+ *
+ * Capturing shares the scene's archetype chunks instead of copying them. The
+ * scene copies a shared chunk the first time it writes to it afterwards, so
+ * each frame duplicates only the chunks it actually changes.
+ *
+ * A snapshot can be read and destroyed on another thread without locking,
+ * but must be released before the scene it came from is destroyed.
+ */
+class SceneSnapshot {
+public:
+    SceneSnapshot() = default;
+    ~SceneSnapshot();
+
+    SceneSnapshot(const SceneSnapshot &) = delete;
+    SceneSnapshot &operator=(const SceneSnapshot &) = delete;
+    SceneSnapshot(SceneSnapshot &&other) noexcept;
+    SceneSnapshot &operator=(SceneSnapshot &&other) noexcept;
+
+    // Releases every shared chunk, leaving the snapshot empty. Storage is
+    // kept for the next Scene::captureSnapshot().
+    void reset();
+
+    [[nodiscard]] bool empty() const;
+    // The scene's change tick at capture time.
+    [[nodiscard]] uint32_t changeTick() const;
+    [[nodiscard]] bool isValid(EntityId id) const;
+
+    template <typename T>
+    [[nodiscard]] bool hasComponent(EntityId id) const {
+        return isValid(id) &&
+               archetypeOf(id).archetype->contains(componentInfo<T>());
+    }
+
+    // Throws if the entity did not exist or lacked a T when captured.
+    template <typename T>
+    [[nodiscard]] const T &component(EntityId id) const {
+        if (!hasComponent<T>(id)) {
+            throw std::runtime_error(
+                "Error: Snapshot entity does not have requested component!\n");
+        }
+
+        const Archetype &archetype = *archetypeOf(id).archetype;
+        const uint32_t row = m_entities[id.index].row;
+        const uint32_t capacity = archetype.chunkCapacity();
+        const auto *column = static_cast<const T *>(archetype.sharedColumn(
+            archetypeOf(id).chunks[row / capacity],
+            *archetype.columnIndex(componentInfo<T>())));
+
+        return column[row % capacity];
+    }
+
+    // Calls function(const Ts &...) or function(EntityId, const Ts &...) for
+    // every entity that held all of Ts, chunk by chunk. Ts may be written
+    // const or not; access is read-only either way.
+    template <typename... Ts, typename Function>
+    void each(Function &&function) const {
+        static_assert(sizeof...(Ts) > 0, "each() needs at least one type");
+
+        const ComponentMask mask = componentMask<std::remove_const_t<Ts>...>();
+        for (const SharedArchetype &shared : m_archetypes) {
+            const Archetype &archetype = *shared.archetype;
+            if (shared.size == 0 || (archetype.mask() & mask) != mask) {
+                continue;
+            }
+
+            const std::array<std::size_t, sizeof...(Ts)> columns = {
+                *archetype.columnIndex(
+                    componentInfo<std::remove_const_t<Ts>>())...};
+
+            for (std::size_t chunk = 0; chunk < shared.chunks.size(); chunk++) {
+                const uint32_t rows = chunkRows(shared, chunk);
+                const std::span<const uint32_t> entities =
+                    archetype.sharedEntities(shared.chunks[chunk], rows);
+                const auto data = columnPointers<Ts...>(
+                    archetype, shared.chunks[chunk], columns,
+                    std::index_sequence_for<Ts...>{});
+
+                for (uint32_t i = 0; i < rows; i++) {
+                    std::apply(
+                        [&](const auto *...components) {
+                            if constexpr (std::is_invocable_v<
+                                              Function, EntityId,
+                                              const Ts &...>) {
+                                const EntityId id{
+                                    entities[i],
+                                    m_entities[entities[i]].generation};
+                                function(id, components[i]...);
+                            } else {
+                                function(components[i]...);
+                            }
+                        },
+                        data);
+                }
+            }
+        }
+    }
+
+    template <typename... Ts>
+    [[nodiscard]] std::size_t count() const {
+        const ComponentMask mask = componentMask<std::remove_const_t<Ts>...>();
+
+        std::size_t total = 0;
+        for (const SharedArchetype &shared : m_archetypes) {
+            if ((shared.archetype->mask() & mask) == mask) {
+                total += shared.size;
+            }
+        }
+
+        return total;
+    }
+
+private:
+    friend class Scene;
+
+    struct SharedArchetype {
+        const Archetype *archetype = nullptr;
+        uint32_t size = 0;
+        std::vector<std::byte *> chunks;
+    };
+
+    struct EntityLocation {
+        // Index into m_archetypes; kNoArchetype for a free slot.
+        uint32_t archetype = kNoArchetype;
+        uint32_t row = 0;
+        uint32_t generation = 0;
+    };
+
+    static constexpr uint32_t kNoArchetype = UINT32_MAX;
+
+    template <typename... Ts>
+    static ComponentMask componentMask() {
+        ComponentMask mask;
+        (mask.set(componentTypeId<Ts>()), ...);
+
+        return mask;
+    }
+
+    template <typename... Ts, std::size_t... Is>
+    static std::tuple<const Ts *...> columnPointers(
+        const Archetype &archetype, const std::byte *chunk,
+        const std::array<std::size_t, sizeof...(Ts)> &columns,
+        std::index_sequence<Is...>) {
+        return {static_cast<const Ts *>(
+            archetype.sharedColumn(chunk, columns[Is]))...};
+    }
+
+    [[nodiscard]] static uint32_t chunkRows(const SharedArchetype &shared,
+                                            std::size_t chunk);
+    [[nodiscard]] const SharedArchetype &archetypeOf(EntityId id) const;
+
+    std::vector<SharedArchetype> m_archetypes;
+    std::vector<EntityLocation> m_entities;
+    uint32_t m_changeTick = 0;
+};
+
+}  // namespace avenir::scene
+
+#endif  // AVENIR_SCENE_SCENESNAPSHOT_HPP
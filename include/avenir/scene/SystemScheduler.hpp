@@ -0,0 +1,139 @@
+#ifndef AVENIR_SCENE_SYSTEMSCHEDULER_HPP
+#define AVENIR_SCENE_SYSTEMSCHEDULER_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "avenir/jobs/JobSystem.hpp"
+#include "avenir/scene/ComponentType.hpp"
+#include "avenir/scene/SceneCommandBuffer.hpp"
+
+namespace avenir::scene {
+
+class Scene;
+
+// Passed to every system when it runs.
+struct SystemContext {
+    Scene &scene;
+    // Structural edits must go through here; they are applied once every
+    // system in the frame has finished.
+    SceneCommandBuffer &commands;
+    float deltaTime;
+    // Scene change tick of the system's previous run, 0 on its first. Pass it
+    // to View::since() to see only what changed in between.
+    uint32_t lastRunTick;
+};
+
+/*
+ * A unit of per-frame work together with the component types it reads and
+ * writes. Two systems conflict when either writes a type the other reads or
+ * writes; conflicting systems run in the order they were added, everything
+ * else may run concurrently.
+ *
+ * Writing Transform implies writing WorldTransform, since it dirties cached
+ * world matrices. Scene::entityWorldMatrix() can refresh those lazily, so a
+ * system calling it should declare writes<WorldTransform>() too.
+ */
+class System {
+public:
+    using Function = std::function<void(const SystemContext &)>;
+
+    System(std::string name, Function function);
+
+    template <typename... Ts>
+    System &reads() {
+        (m_reads.set(componentTypeId<Ts>()), ...);
+        return *this;
+    }
+
+    template <typename... Ts>
+    System &writes() {
+        (m_writes.set(componentTypeId<Ts>()), ...);
+        return *this;
+    }
+
+    // Pins the system to the job system's main thread, for work such as
+    // polling input that the windowing layer only allows there.
+    System &runOnMainThread();
+
+    [[nodiscard]] const std::string &name() const;
+    [[nodiscard]] bool conflictsWith(const System &other) const;
+
+private:
+    friend class SystemScheduler;
+
+    std::string m_name;
+    Function m_function;
+    ComponentMask m_reads;
+    ComponentMask m_writes;
+    bool m_mainThread = false;
+};
+
+/*
+ * Runs a scene's systems once per frame as jobs. The systems form a dependency
+ * graph built from their declared component access; a system is started as
+ * soon as every earlier system it conflicts with has finished. The calling
+ * thread takes part in the frame, and must be the job system's main thread if
+ * any system is pinned there.
+ *
+ * Systems must not create, destroy or restructure entities directly. Each
+ * system gets its own command buffer instead, and all of them are applied to
+ * the scene in one batch at the end of run(), after which the scene's change
+ * tick is advanced.
+ */
+class SystemScheduler {
+public:
+    // Uses jobs::JobSystem::shared().
+    explicit SystemScheduler(Scene &scene);
+    SystemScheduler(Scene &scene, jobs::JobSystem &jobSystem);
+
+    SystemScheduler(const SystemScheduler &) = delete;
+    SystemScheduler &operator=(const SystemScheduler &) = delete;
+
+    // The returned reference stays valid for the scheduler's lifetime.
+    System &addSystem(std::string name, System::Function function);
+
+    // Runs every system once. If any system throws, the rest of the frame
+    // still completes and the first exception is rethrown afterwards; the
+    // frame's commands are discarded in that case.
+    void run(float deltaTime);
+
+private:
+    struct Node {
+        explicit Node(System system) : system(std::move(system)) {}
+
+        System system;
+        SceneCommandBuffer commands;
+        std::vector<Node *> successors;
+        uint32_t dependencyCount = 0;
+        std::atomic<uint32_t> remainingDependencies = 0;
+        uint32_t lastRunTick = 0;
+    };
+
+    void buildGraph();
+    void dispatch(Node &node);
+    void execute(Node &node);
+
+    Scene *m_scene;
+    jobs::JobSystem *m_jobSystem;
+    std::vector<std::unique_ptr<Node>> m_nodes;
+    bool m_graphDirty = false;
+    bool m_hasMainThreadSystems = false;
+
+    jobs::Counter m_frame;
+    float m_deltaTime = 0.0f;
+    std::mutex m_exceptionMutex;
+    std::exception_ptr m_exception;
+
+    std::vector<SceneCommandBuffer *> m_commandBuffers;
+};
+
+}  // namespace avenir::scene
+
+#endif  // AVENIR_SCENE_SYSTEMSCHEDULER_HPP
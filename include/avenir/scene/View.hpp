@@ -0,0 +1,72 @@
+#ifndef AVENIR_SCENE_VIEW_HPP
+#define AVENIR_SCENE_VIEW_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace avenir::scene {
+
+class Scene;
+
+/*
+ * Query filter: View<Changed<Transform>> visits only entities whose Transform
+ * was written at or after the view's `since` tick, and still hands the
+ * callback a Transform &. Use Changed<const T> to read without stamping the
+ * component as changed again.
+ */
+template <typename T>
+struct Changed {};
+
+// Maps a query argument to the component it names and the reference the
+// callback receives.
+template <typename T>
+struct QueryTerm {
+    using Component = std::remove_const_t<T>;
+    using Reference = T &;
+    static constexpr bool isChanged = false;
+    static constexpr bool isMutable = !std::is_const_v<T>;
+};
+
+template <typename T>
+struct QueryTerm<Changed<T>> : QueryTerm<T> {
+    static constexpr bool isChanged = true;
+};
+
+/*
+ * Every entity in a Scene that has all of the component types Ts. Matching
+ * archetypes are cached by the scene per component signature, so a view only
+ * re-examines archetypes created since it was last iterated.
+ *
+ * Declaring a type const (e.g. View<const Transform, Camera>) grants read-only
+ * access. Mutable access stamps the component with the scene's change tick,
+ * and a mutable Transform also marks each visited entity's world matrix dirty.
+ * Entities must not be created, destroyed or restructured during iteration.
+ *
+ * Template members are defined at the bottom of Scene.hpp.
+ */
+template <typename... Ts>
+class View {
+public:
+    View(Scene &scene, uint32_t since) : m_scene(&scene), m_since(since) {}
+
+    // Changed<> terms match changes at or after `tick` instead of only those
+    // made during the scene's current tick.
+    [[nodiscard]] View since(uint32_t tick) const {
+        return View(*m_scene, tick);
+    }
+
+    // Calls function(Ts &...) or function(Entity, Ts &...) per match.
+    template <typename Function>
+    void each(Function &&function) const;
+
+    [[nodiscard]] std::size_t size() const;
+
+private:
+    Scene *m_scene;
+    uint32_t m_since;
+};
+
+}  // namespace avenir::scene
+
+#endif  // AVENIR_SCENE_VIEW_HPP
@@ -1,13 +1,20 @@
 #ifndef AVENIR_SCENE_COMPONENTS_CAMERA_HPP
 #define AVENIR_SCENE_COMPONENTS_CAMERA_HPP
 
+#include <string_view>
+
+#include <glm/mat4x4.hpp>
+
 #include "avenir/scene/Component.hpp"
 
 namespace avenir::scene::components {
 
 struct Camera final : public Component {
-    [[nodiscard]] std::unique_ptr<Component> clone() const override;
-    [[nodiscard]] std::string name() const override;
+    [[nodiscard]] std::string_view name() const;
+
+    // Perspective projection from fov (vertical, in degrees) and the clip
+    // planes, in glm's conventions; a Vulkan renderer flips Y itself.
+    [[nodiscard]] glm::mat4 projectionMatrix(float aspectRatio) const;
 
     float fov = 45.0f;
     float nearPlane = 0.1f;
@@ -1,16 +1,23 @@
 #ifndef AVENIR_SCENE_COMPONENTS_MESHRENDERER_HPP
 #define AVENIR_SCENE_COMPONENTS_MESHRENDERER_HPP
 
-#include <string>
+#include <string_view>
 
+#include "avenir/graphics/MeshHandle.hpp"
+#include "avenir/scene/Bounds.hpp"
 #include "avenir/scene/Component.hpp"
 
 namespace avenir::scene::components {
 
 struct MeshRenderer final : public Component {
-    [[nodiscard]] std::unique_ptr<Component> clone() const override;
+    // Mesh added through Renderer::addMesh(); entities whose handle is not
+    // valid in the renderer are not drawn.
+    graphics::MeshHandle mesh;
+    // Mesh-space bounds, placed in the scene's spatial index through the
+    // entity's WorldTransform.
+    Aabb localBounds = {glm::vec3(-0.5f), glm::vec3(0.5f)};
 
-    [[nodiscard]] std::string name() const override;
+    [[nodiscard]] std::string_view name() const;
     static constexpr std::string_view staticName = "MeshRenderer";
 };
 
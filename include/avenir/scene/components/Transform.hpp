@@ -5,7 +5,8 @@
 #ifndef AVENIR_TRANSFORM_HPP
 #define AVENIR_TRANSFORM_HPP
 
-#include <string>
+#include <span>
+#include <string_view>
 
 #include <glm/vec3.hpp>
 #include <glm/mat4x4.hpp>
@@ -15,6 +16,21 @@
 
 namespace avenir::scene::components {
 
+// Structure-of-arrays view over a batch of transforms: one tightly packed float
+// stream per scalar, all of the same length.
+struct TransformArrays {
+    std::span<const float> positionX;
+    std::span<const float> positionY;
+    std::span<const float> positionZ;
+    std::span<const float> rotationX;
+    std::span<const float> rotationY;
+    std::span<const float> rotationZ;
+    std::span<const float> rotationW;
+    std::span<const float> scaleX;
+    std::span<const float> scaleY;
+    std::span<const float> scaleZ;
+};
+
 struct Transform final : public Component {
     Transform() = default;
     explicit Transform(glm::vec3 position);
@@ -30,8 +46,13 @@ struct Transform final : public Component {
     [[nodiscard]] glm::mat4 localMatrix() const;
     [[nodiscard]] glm::mat4 inverseLocalMatrix() const;
 
-    [[nodiscard]] std::unique_ptr<Component> clone() const override;
-    [[nodiscard]] std::string name() const override;
+    // Batched localMatrix(): writes one matrix per element of `transforms`.
+    // Uses AVX2 or SSE where available, eight or four transforms at a time,
+    // and a scalar loop for the remainder or on other architectures.
+    static void localMatrices(const TransformArrays &transforms,
+                              std::span<glm::mat4> matrices);
+
+    [[nodiscard]] std::string_view name() const;
     static constexpr std::string_view staticName = "Transform";
 };
 
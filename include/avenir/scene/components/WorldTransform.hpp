@@ -0,0 +1,25 @@
+#ifndef AVENIR_SCENE_COMPONENTS_WORLDTRANSFORM_HPP
+#define AVENIR_SCENE_COMPONENTS_WORLDTRANSFORM_HPP
+
+#include <string_view>
+
+#include <glm/mat4x4.hpp>
+
+#include "avenir/scene/Component.hpp"
+
+namespace avenir::scene::components {
+
+// Cached local-to-world matrix and its inverse, maintained by Scene from the
+// entity's Transform and its parent chain. Not meant to be written by gameplay
+// code.
+struct WorldTransform final : public Component {
+    glm::mat4 matrix = glm::mat4(1.0f);
+    glm::mat4 inverseMatrix = glm::mat4(1.0f);
+
+    [[nodiscard]] std::string_view name() const;
+    static constexpr std::string_view staticName = "WorldTransform";
+};
+
+}  // namespace avenir::scene::components
+
+#endif  // AVENIR_SCENE_COMPONENTS_WORLDTRANSFORM_HPP
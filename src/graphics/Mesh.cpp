@@ -1,9 +1,72 @@
 #include "avenir/graphics/Mesh.hpp"
 
+#include <utility>
+
 namespace avenir::graphics {
-std::vector<Vertex> Mesh::vertices() const { return m_vertices; }
+Mesh::Mesh(std::vector<Vertex> vertices, std::vector<uint16_t> indices)
+    : m_vertices(std::move(vertices)), m_indices(std::move(indices)) {}
+
+Mesh Mesh::cube() {
+    /*
+     * Vulkan and glTF models by default handles vertices in a
+     * counter-clockwise winding order, as shown below how our quad is being
+     * rendered.
+     *
+     * Vertices:    UV Coordinates:
+     * 3  2         0,0  1,0
+     * +--+           +--+
+     * | /|           | /|
+     * |/ |           |/ |
+     * +--+           +--+
+     * 0  1         0,1  1,1
+     */
+    return {{// Front face
+             {{-0.5f, -0.5f, 0.5f}, {1.0f, 1.0f, 1.0f}, {0.0f, 1.0f}},
+             {{0.5f, -0.5f, 0.5f}, {1.0f, 1.0f, 1.0f}, {1.0f, 1.0f}},
+             {{0.5f, 0.5f, 0.5f}, {1.0f, 1.0f, 1.0f}, {1.0f, 0.0f}},
+             {{-0.5f, 0.5f, 0.5f}, {1.0f, 1.0f, 1.0f}, {0.0f, 0.0f}},
+
+             // Back face
+             {{0.5f, -0.5f, -0.5f}, {1.0f, 1.0f, 1.0f}, {0.0f, 1.0f}},
+             {{-0.5f, -0.5f, -0.5f}, {1.0f, 1.0f, 1.0f}, {1.0f, 1.0f}},
+             {{-0.5f, 0.5f, -0.5f}, {1.0f, 1.0f, 1.0f}, {1.0f, 0.0f}},
+             {{0.5f, 0.5f, -0.5f}, {1.0f, 1.0f, 1.0f}, {0.0f, 0.0f}}},
+            {// Front
+             0, 1, 2, 2, 3, 0,
+
+             // Back
+             4, 5, 6, 6, 7, 4,
 
-std::vector<uint16_t> Mesh::indices() const { return m_indices; }
+             // Left
+             5, 0, 3, 3, 6, 5,
+
+             // Right
+             1, 4, 7, 7, 2, 1,
+
+             // Top
+             3, 2, 7, 7, 6, 3,
+             // Bottom
+             5, 4, 1, 1, 0, 5}};
+}
+
+const std::vector<Vertex> &Mesh::vertices() const { return m_vertices; }
+
+const std::vector<uint16_t> &Mesh::indices() const { return m_indices; }
+
+scene::Aabb Mesh::bounds() const {
+    if (m_vertices.empty()) {
+        return {};
+    }
+
+    scene::Aabb bounds{m_vertices.front().position,
+                       m_vertices.front().position};
+    for (const Vertex &vertex : m_vertices) {
+        bounds.min = glm::min(bounds.min, vertex.position);
+        bounds.max = glm::max(bounds.max, vertex.position);
+    }
+
+    return bounds;
+}
 
 void Mesh::setVertices(const std::vector<Vertex> &vertices) {
     m_vertices = vertices;
@@ -13,4 +76,4 @@ void Mesh::setIndices(const std::vector<uint16_t> &indices) {
     m_indices = indices;
 }
 
-}  // namespace avenir::graphics
\ No newline at end of file
+}  // namespace avenir::graphics
@@ -0,0 +1,110 @@
+#include "avenir/graphics/MeshRegistry.hpp"
+
+#include <algorithm>
+#include <optional>
+#include <stdexcept>
+
+#include "avenir/graphics/Mesh.hpp"
+
+namespace avenir::graphics {
+
+MeshRegistry::MeshRegistry(const uint32_t vertexCapacity,
+                           const uint32_t indexCapacity)
+    : m_vertices(vertexCapacity), m_indices(indexCapacity) {}
+
+MeshHandle MeshRegistry::add(const Mesh &mesh) {
+    if (mesh.vertices().empty() || mesh.indices().empty()) {
+        throw std::runtime_error("Error: Cannot add an empty mesh!\n");
+    }
+
+    MeshRange range;
+    range.vertexCount = static_cast<uint32_t>(mesh.vertices().size());
+    range.indexCount = static_cast<uint32_t>(mesh.indices().size());
+    range.firstVertex = allocate(m_vertices, range.vertexCount);
+    try {
+        range.firstIndex = allocate(m_indices, range.indexCount);
+    } catch (...) {
+        m_vertices.free(range.firstVertex, range.vertexCount);
+        throw;
+    }
+
+    uint32_t index;
+    if (!m_freeSlots.empty()) {
+        index = m_freeSlots.back();
+        m_freeSlots.pop_back();
+    } else {
+        index = static_cast<uint32_t>(m_slots.size());
+        m_slots.emplace_back();
+    }
+
+    Slot &slot = m_slots[index];
+    slot.range = range;
+    slot.alive = true;
+    m_size++;
+
+    return {index, slot.generation};
+}
+
+MeshRange MeshRegistry::remove(const MeshHandle handle) {
+    if (!isValid(handle)) {
+        throw std::runtime_error("Error: Cannot remove invalid mesh!\n");
+    }
+
+    Slot &slot = m_slots[handle.index];
+    slot.alive = false;
+    slot.generation++;
+    m_freeSlots.emplace_back(handle.index);
+    m_size--;
+
+    return slot.range;
+}
+
+void MeshRegistry::release(const MeshRange &range) {
+    m_vertices.free(range.firstVertex, range.vertexCount);
+    m_indices.free(range.firstIndex, range.indexCount);
+}
+
+bool MeshRegistry::isValid(const MeshHandle handle) const {
+    return handle.index < m_slots.size() && m_slots[handle.index].alive &&
+           m_slots[handle.index].generation == handle.generation;
+}
+
+const MeshRange &MeshRegistry::range(const MeshHandle handle) const {
+    if (!isValid(handle)) {
+        throw std::runtime_error("Error: Mesh handle is not valid!\n");
+    }
+
+    return m_slots[handle.index].range;
+}
+
+uint32_t MeshRegistry::vertexCapacity() const {
+    return static_cast<uint32_t>(m_vertices.capacity());
+}
+
+uint32_t MeshRegistry::indexCapacity() const {
+    return static_cast<uint32_t>(m_indices.capacity());
+}
+
+std::size_t MeshRegistry::size() const { return m_size; }
+
+uint32_t MeshRegistry::slotCount() const {
+    return static_cast<uint32_t>(m_slots.size());
+}
+
+uint32_t MeshRegistry::allocate(RangeAllocator &allocator,
+                                const uint32_t count) {
+    std::optional<uint64_t> offset = allocator.allocate(count);
+    while (!offset) {
+        const uint64_t capacity = std::max<uint64_t>(allocator.capacity(), 1);
+        if (capacity * 2 > UINT32_MAX) {
+            throw std::runtime_error("Error: Mesh registry is full!\n");
+        }
+
+        allocator.grow(capacity * 2);
+        offset = allocator.allocate(count);
+    }
+
+    return static_cast<uint32_t>(*offset);
+}
+
+}  // namespace avenir::graphics
@@ -0,0 +1,105 @@
+#include "avenir/graphics/RangeAllocator.hpp"
+
+#include <iterator>
+#include <stdexcept>
+
+namespace avenir::graphics {
+
+RangeAllocator::RangeAllocator(const uint64_t capacity) {
+    grow(capacity);
+}
+
+std::optional<uint64_t> RangeAllocator::allocate(const uint64_t size,
+                                                 const uint64_t alignment) {
+    if (size == 0) {
+        throw std::runtime_error("Error: Cannot allocate an empty range!\n");
+    }
+
+    // Smallest ranges first; only alignment padding can make one that is
+    // large enough not fit, so this rarely looks past the first candidate.
+    for (auto it = m_freeSizes.lower_bound({size, 0}); it != m_freeSizes.end();
+         ++it) {
+        const auto [freeSize, offset] = *it;
+        const uint64_t aligned = (offset + alignment - 1) & ~(alignment - 1);
+        if (freeSize < aligned - offset + size) {
+            continue;
+        }
+
+        eraseFreeRange(m_freeRanges.find(offset));
+
+        // Alignment padding in front and the unused tail stay free.
+        if (aligned > offset) {
+            insertFreeRange(offset, aligned - offset);
+        }
+
+        if (const uint64_t end = aligned + size; end < offset + freeSize) {
+            insertFreeRange(end, offset + freeSize - end);
+        }
+
+        m_used += size;
+
+        return aligned;
+    }
+
+    return std::nullopt;
+}
+
+void RangeAllocator::free(const uint64_t offset, const uint64_t size) {
+    m_used -= size;
+    insertFreeRange(offset, size);
+}
+
+void RangeAllocator::grow(const uint64_t capacity) {
+    if (capacity < m_capacity) {
+        throw std::runtime_error("Error: Range allocator cannot shrink!\n");
+    }
+
+    if (capacity > m_capacity) {
+        const uint64_t previous = m_capacity;
+        m_capacity = capacity;
+        insertFreeRange(previous, capacity - previous);
+    }
+}
+
+uint64_t RangeAllocator::capacity() const { return m_capacity; }
+
+uint64_t RangeAllocator::used() const { return m_used; }
+
+bool RangeAllocator::empty() const { return m_used == 0; }
+
+std::size_t RangeAllocator::freeRangeCount() const {
+    return m_freeRanges.size();
+}
+
+uint64_t RangeAllocator::largestFreeRange() const {
+    return m_freeSizes.empty() ? 0 : m_freeSizes.rbegin()->first;
+}
+
+void RangeAllocator::insertFreeRange(uint64_t offset, uint64_t size) {
+    auto next = m_freeRanges.lower_bound(offset);
+
+    if (next != m_freeRanges.begin()) {
+        if (const auto previous = std::prev(next);
+            previous->first + previous->second == offset) {
+            offset = previous->first;
+            size += previous->second;
+            eraseFreeRange(previous);
+        }
+    }
+
+    if (next != m_freeRanges.end() && offset + size == next->first) {
+        size += next->second;
+        eraseFreeRange(next);
+    }
+
+    m_freeRanges.emplace(offset, size);
+    m_freeSizes.emplace(size, offset);
+}
+
+void RangeAllocator::eraseFreeRange(
+    const std::map<uint64_t, uint64_t>::iterator range) {
+    m_freeSizes.erase({range->second, range->first});
+    m_freeRanges.erase(range);
+}
+
+}  // namespace avenir::graphics
@@ -0,0 +1,342 @@
+#include "avenir/graphics/vulkan/VulkanMemoryAllocator.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+
+namespace avenir::graphics::vulkan {
+
+VulkanAllocation::~VulkanAllocation() { release(); }
+
+VulkanAllocation::VulkanAllocation(VulkanAllocation &&other) noexcept
+    : m_allocator(std::exchange(other.m_allocator, nullptr)),
+      m_memory(std::exchange(other.m_memory, nullptr)),
+      m_offset(other.m_offset),
+      m_size(other.m_size),
+      m_mapped(std::exchange(other.m_mapped, nullptr)),
+      m_pool(other.m_pool),
+      m_block(other.m_block) {}
+
+VulkanAllocation &VulkanAllocation::operator=(
+    VulkanAllocation &&other) noexcept {
+    if (this != &other) {
+        release();
+        m_allocator = std::exchange(other.m_allocator, nullptr);
+        m_memory = std::exchange(other.m_memory, nullptr);
+        m_offset = other.m_offset;
+        m_size = other.m_size;
+        m_mapped = std::exchange(other.m_mapped, nullptr);
+        m_pool = other.m_pool;
+        m_block = other.m_block;
+    }
+
+    return *this;
+}
+
+vk::DeviceMemory VulkanAllocation::memory() const { return m_memory; }
+
+vk::DeviceSize VulkanAllocation::offset() const { return m_offset; }
+
+vk::DeviceSize VulkanAllocation::size() const { return m_size; }
+
+void *VulkanAllocation::mapped() const { return m_mapped; }
+
+void VulkanAllocation::release() {
+    if (m_allocator) {
+        m_allocator->free(*this);
+        m_allocator = nullptr;
+        m_memory = nullptr;
+        m_mapped = nullptr;
+    }
+}
+
+float VulkanMemoryStatistics::fragmentation() const {
+    const vk::DeviceSize freeBytes = reservedBytes - usedBytes;
+    if (freeBytes == 0) {
+        return 0.0f;
+    }
+
+    return 1.0f - static_cast<float>(largestFreeRange) /
+                      static_cast<float>(freeBytes);
+}
+
+VulkanMemoryAllocator::VulkanMemoryAllocator(
+    const vk::raii::PhysicalDevice &physicalDevice,
+    const vk::raii::Device &logicalDevice)
+    : m_logicalDevice(&logicalDevice),
+      m_memoryProperties(physicalDevice.getMemoryProperties()) {
+    const vk::PhysicalDeviceLimits limits =
+        physicalDevice.getProperties().limits;
+    m_bufferImageGranularity = limits.bufferImageGranularity;
+    m_maxAllocationCount = limits.maxMemoryAllocationCount;
+}
+
+VulkanMemoryAllocator::~VulkanMemoryAllocator() = default;
+
+VulkanAllocation VulkanMemoryAllocator::allocate(
+    const vk::MemoryRequirements &requirements,
+    const vk::MemoryPropertyFlags properties, VulkanResourceKind kind) {
+    const uint32_t memoryType =
+        findMemoryType(requirements.memoryTypeBits, properties);
+
+    // Without a granularity constraint images can share linear blocks.
+    if (kind == VulkanResourceKind::eOptimalImage &&
+        m_bufferImageGranularity <= 1) {
+        kind = VulkanResourceKind::eLinear;
+    }
+
+    const vk::DeviceSize size = blockSize(memoryType, kind);
+    if (requirements.size > size / 2) {
+        return allocateDedicated(memoryType, requirements.size);
+    }
+
+    const uint32_t pool = poolIndex(memoryType, kind);
+
+    VulkanAllocation allocation;
+    for (uint32_t block = 0; block < m_pools[pool].blocks.size(); block++) {
+        if (m_pools[pool].blocks[block] &&
+            allocateFromBlock(pool, block, requirements, allocation)) {
+            return allocation;
+        }
+    }
+
+    auto created = std::make_unique<Block>();
+    created->memory = allocateDeviceMemory(memoryType, size, &created->mapped);
+    created->size = size;
+    if (kind != VulkanResourceKind::eTransient) {
+        created->ranges.grow(size);
+    }
+
+    std::vector<std::unique_ptr<Block>> &blocks = m_pools[pool].blocks;
+    auto slot = std::ranges::find_if(
+        blocks, [](const auto &block) { return block == nullptr; });
+    if (slot == blocks.end()) {
+        slot = blocks.emplace(blocks.end());
+    }
+
+    *slot = std::move(created);
+
+    if (!allocateFromBlock(pool, static_cast<uint32_t>(slot - blocks.begin()),
+                           requirements, allocation)) {
+        throw std::runtime_error(
+            "[Vulkan] Error: Failed to suballocate from a new memory "
+            "block!\n");
+    }
+
+    return allocation;
+}
+
+VulkanMemoryStatistics VulkanMemoryAllocator::statistics() const {
+    VulkanMemoryStatistics statistics{};
+    statistics.deviceMemoryCount = m_deviceMemoryCount;
+    statistics.allocationCount = m_allocationCount;
+    statistics.reservedBytes = m_dedicatedBytes;
+    statistics.usedBytes = m_dedicatedBytes;
+
+    for (const vk::raii::DeviceMemory &memory : m_dedicated) {
+        if (*memory) {
+            statistics.dedicatedAllocationCount++;
+        }
+    }
+
+    for (const Pool &pool : m_pools) {
+        for (const std::unique_ptr<Block> &block : pool.blocks) {
+            if (!block) {
+                continue;
+            }
+
+            statistics.reservedBytes += block->size;
+
+            // A transient page has one free range, above its top.
+            if (pool.kind == VulkanResourceKind::eTransient) {
+                statistics.usedBytes += block->top;
+                statistics.freeRangeCount += block->top < block->size;
+                statistics.largestFreeRange = std::max(
+                    statistics.largestFreeRange, block->size - block->top);
+                continue;
+            }
+
+            statistics.usedBytes += block->ranges.used();
+            statistics.freeRangeCount +=
+                static_cast<uint32_t>(block->ranges.freeRangeCount());
+            statistics.largestFreeRange = std::max(
+                statistics.largestFreeRange, block->ranges.largestFreeRange());
+        }
+    }
+
+    return statistics;
+}
+
+uint32_t VulkanMemoryAllocator::findMemoryType(
+    const uint32_t typeFilter, const vk::MemoryPropertyFlags properties) const {
+    for (uint32_t i = 0; i < m_memoryProperties.memoryTypeCount; ++i) {
+        // If there is a memory type suitable for the resource that also has
+        // all the properties we need, then we return its index
+        if ((typeFilter & (1 << i)) &&
+            (m_memoryProperties.memoryTypes[i].propertyFlags & properties) ==
+                properties) {
+            return i;
+        }
+    }
+
+    throw std::runtime_error(
+        "[Vulkan] Error: Failed to find suitable memory type!\n");
+}
+
+vk::DeviceSize VulkanMemoryAllocator::blockSize(
+    const uint32_t memoryType, const VulkanResourceKind kind) const {
+    const vk::DeviceSize preferred = kind == VulkanResourceKind::eTransient
+                                         ? kTransientPageSize
+                                         : kBlockSize;
+
+    // Small heaps, such as the host-visible device-local window, would be
+    // used up by a handful of blocks.
+    const uint32_t heap = m_memoryProperties.memoryTypes[memoryType].heapIndex;
+    return std::min(preferred, m_memoryProperties.memoryHeaps[heap].size / 8);
+}
+
+uint32_t VulkanMemoryAllocator::poolIndex(const uint32_t memoryType,
+                                          const VulkanResourceKind kind) {
+    for (uint32_t pool = 0; pool < m_pools.size(); pool++) {
+        if (m_pools[pool].memoryType == memoryType &&
+            m_pools[pool].kind == kind) {
+            return pool;
+        }
+    }
+
+    m_pools.emplace_back(Pool{memoryType, kind, {}});
+
+    return static_cast<uint32_t>(m_pools.size() - 1);
+}
+
+vk::raii::DeviceMemory VulkanMemoryAllocator::allocateDeviceMemory(
+    const uint32_t memoryType, const vk::DeviceSize size, void **mapped) {
+    if (m_deviceMemoryCount >= m_maxAllocationCount) {
+        throw std::runtime_error(
+            "[Vulkan] Error: Exceeded maxMemoryAllocationCount!\n");
+    }
+
+    const vk::MemoryAllocateInfo memoryAllocateInfo =
+        vk::MemoryAllocateInfo().setAllocationSize(size).setMemoryTypeIndex(
+            memoryType);
+
+    vk::raii::DeviceMemory memory(*m_logicalDevice, memoryAllocateInfo);
+
+    *mapped = nullptr;
+    if (m_memoryProperties.memoryTypes[memoryType].propertyFlags &
+        vk::MemoryPropertyFlagBits::eHostVisible) {
+        *mapped = memory.mapMemory(0, vk::WholeSize);
+    }
+
+    m_deviceMemoryCount++;
+
+    return memory;
+}
+
+VulkanAllocation VulkanMemoryAllocator::allocateDedicated(
+    const uint32_t memoryType, const vk::DeviceSize size) {
+    VulkanAllocation allocation;
+    vk::raii::DeviceMemory memory =
+        allocateDeviceMemory(memoryType, size, &allocation.m_mapped);
+
+    uint32_t index;
+    if (!m_freeDedicated.empty()) {
+        index = m_freeDedicated.back();
+        m_freeDedicated.pop_back();
+        m_dedicated[index] = std::move(memory);
+    } else {
+        index = static_cast<uint32_t>(m_dedicated.size());
+        m_dedicated.emplace_back(std::move(memory));
+    }
+
+    allocation.m_allocator = this;
+    allocation.m_memory = *m_dedicated[index];
+    allocation.m_offset = 0;
+    allocation.m_size = size;
+    allocation.m_pool = index;
+    allocation.m_block = kDedicated;
+
+    m_allocationCount++;
+    m_dedicatedBytes += size;
+
+    return allocation;
+}
+
+bool VulkanMemoryAllocator::allocateFromBlock(
+    const uint32_t pool, const uint32_t block,
+    const vk::MemoryRequirements &requirements, VulkanAllocation &allocation) {
+    Block &target = *m_pools[pool].blocks[block];
+
+    vk::DeviceSize offset;
+    if (m_pools[pool].kind == VulkanResourceKind::eTransient) {
+        offset = (target.top + requirements.alignment - 1) &
+                 ~(requirements.alignment - 1);
+        if (offset + requirements.size > target.size) {
+            return false;
+        }
+
+        target.top = offset + requirements.size;
+    } else {
+        const std::optional<uint64_t> range =
+            target.ranges.allocate(requirements.size, requirements.alignment);
+        if (!range) {
+            return false;
+        }
+
+        offset = *range;
+    }
+
+    target.allocationCount++;
+    m_allocationCount++;
+
+    allocation.m_allocator = this;
+    allocation.m_memory = *target.memory;
+    allocation.m_offset = offset;
+    allocation.m_size = requirements.size;
+    allocation.m_mapped =
+        target.mapped ? static_cast<std::byte *>(target.mapped) + offset
+                      : nullptr;
+    allocation.m_pool = pool;
+    allocation.m_block = block;
+
+    return true;
+}
+
+void VulkanMemoryAllocator::free(VulkanAllocation &allocation) {
+    m_allocationCount--;
+
+    if (allocation.m_block == kDedicated) {
+        m_dedicated[allocation.m_pool] = nullptr;
+        m_freeDedicated.emplace_back(allocation.m_pool);
+        m_deviceMemoryCount--;
+        m_dedicatedBytes -= allocation.m_size;
+        return;
+    }
+
+    Pool &pool = m_pools[allocation.m_pool];
+    Block &block = *pool.blocks[allocation.m_block];
+    if (pool.kind != VulkanResourceKind::eTransient) {
+        block.ranges.free(allocation.m_offset, allocation.m_size);
+    }
+
+    if (--block.allocationCount > 0) {
+        return;
+    }
+
+    block.top = 0;
+
+    // Keep one empty block per pool so a pool that repeatedly drains and
+    // refills does not allocate device memory every time.
+    const bool hasOtherBlock =
+        std::ranges::any_of(pool.blocks, [&](const auto &other) {
+            return other && other.get() != &block;
+        });
+    if (hasOtherBlock) {
+        pool.blocks[allocation.m_block] = nullptr;
+        m_deviceMemoryCount--;
+    }
+}
+
+}  // namespace avenir::graphics::vulkan
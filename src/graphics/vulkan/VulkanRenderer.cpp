@@ -1,13 +1,19 @@
 #include "avenir/graphics/vulkan/VulkanRenderer.hpp"
 
+#include <algorithm>
+#include <bit>
 #include <chrono>
 #include <cstdint>
 #include <fstream>
 #include <iostream>
+#include <optional>
+#include <sstream>
+#include <span>
 #include <string>
 #include <vector>
 
 #include "avenir/debug/Debug.hpp"
+#include "avenir/scene/Scene.hpp"
 
 namespace avenir::graphics::vulkan {
 
@@ -19,13 +25,15 @@ VulkanRenderer::VulkanRenderer(GLFWwindow *window) : m_glfwWindow(window) {
     createImageViews();
     createDescriptorSetLayout();
     createGraphicsPipeline();
+    createCullingPipelines();
     createCommandPool();
+    createUploader();
     createTextureImage();
     createTextureImageView();
     createTextureSampler();
-    createVertexBuffer();
-    createIndexBuffer();
+    createMeshBuffers();
     createUniformBuffers();
+    createCullingBuffers();
     createDescriptorPool();
     createDescriptorSets();
     createCommandBuffers();
@@ -44,17 +52,50 @@ VulkanRenderer::~VulkanRenderer() {
     cleanupSwapchain();
 
     std::cout << "---------------------------------------------------\n";
+    logMemoryStatistics();
     Debug::log("[Vulkan] Shutting down...",
                Debug::MessageSeverity::eInformation);
 }
 
-void VulkanRenderer::drawFrame(const glm::mat4 cameraViewMatrix) {
+VulkanMemoryStatistics VulkanRenderer::memoryStatistics() const {
+    return m_memoryAllocator->statistics();
+}
+
+void VulkanRenderer::logMemoryStatistics() const {
+    const VulkanMemoryStatistics statistics = memoryStatistics();
+
+    std::ostringstream message;
+    message << "[Vulkan] Memory: " << statistics.allocationCount
+            << " allocations in " << statistics.deviceMemoryCount
+            << " device memory objects (" << statistics.dedicatedAllocationCount
+            << " dedicated), " << (statistics.usedBytes >> 10)
+            << " KiB used of " << (statistics.reservedBytes >> 10) << " KiB, "
+            << statistics.freeRangeCount << " free ranges, fragmentation "
+            << statistics.fragmentation();
+    Debug::log(message.str(), Debug::MessageSeverity::eInformation);
+}
+
+void VulkanRenderer::drawFrame(scene::Scene &scene) {
+    const std::optional<scene::EntityId> camera = scene.primaryCamera();
+    if (!camera) {
+        throw std::runtime_error(
+            "[Vulkan] Error: Scene has no primary camera!\n");
+    }
+
+    // Gathered before waiting on the fence so the CPU work overlaps the
+    // frame still in flight. Culling happens on the GPU.
+    m_frustumCuller.gather(scene, *camera,
+                           static_cast<float>(m_swapchainExtent.width) /
+                               static_cast<float>(m_swapchainExtent.height));
+
     while (vk::Result::eTimeout ==
            m_logicalDevice.waitForFences(*m_inFlightFences[m_currentFrame],
                                          vk::True, UINT64_MAX)) {
         ;
     }
 
+    releaseRemovedMeshes();
+
     auto [result, imageIndex] = m_swapchain.acquireNextImage(
         UINT64_MAX, *m_presentCompleteSemaphores[m_semaphoreIndex], nullptr);
 
@@ -69,7 +110,13 @@ void VulkanRenderer::drawFrame(const glm::mat4 cameraViewMatrix) {
             "[Vulkan] Error: Failed to acquire swapchain image!\n");
     }
 
-    updateUniformBuffer(m_currentFrame, cameraViewMatrix);
+    updateUniformBuffer(m_currentFrame, m_frustumCuller.viewMatrix(),
+                        m_frustumCuller.projectionMatrix());
+    updateCullingBuffers(m_currentFrame);
+
+    // Uploads recorded since the last frame go first, so this frame sees
+    // them.
+    m_uploader->submit();
 
     m_logicalDevice.resetFences(*m_inFlightFences[m_currentFrame]);
 
@@ -89,6 +136,7 @@ void VulkanRenderer::drawFrame(const glm::mat4 cameraViewMatrix) {
             .setPSignalSemaphores(&*m_renderFinishedSemaphores[imageIndex]);
 
     m_queue.submit(submitInfo, *m_inFlightFences[m_currentFrame]);
+    m_submittedFrames++;
 
     try {
         const vk::PresentInfoKHR presentInfoKHR =
@@ -128,6 +176,33 @@ void VulkanRenderer::onFramebufferResize(int width, int height) {
     m_framebufferResized = true;
 }
 
+MeshHandle VulkanRenderer::addMesh(const Mesh &mesh) {
+    const MeshHandle handle = m_meshRegistry.add(mesh);
+    if (m_meshRegistry.vertexCapacity() > m_vertexBufferCapacity ||
+        m_meshRegistry.indexCapacity() > m_indexBufferCapacity) {
+        growMeshBuffers();
+    }
+
+    // Frames in flight only read other ranges of the buffers, so the copies
+    // need no wait on them.
+    const MeshRange &range = m_meshRegistry.range(handle);
+    m_uploader->uploadBuffer(mesh.vertices().data(),
+                             sizeof(VulkanVertex) * range.vertexCount,
+                             m_vertexBuffer,
+                             sizeof(VulkanVertex) * range.firstVertex);
+    m_uploader->uploadBuffer(mesh.indices().data(),
+                             sizeof(uint16_t) * range.indexCount,
+                             m_indexBuffer,
+                             sizeof(uint16_t) * range.firstIndex);
+
+    return handle;
+}
+
+void VulkanRenderer::removeMesh(const MeshHandle mesh) {
+    m_removedMeshes.emplace_back(m_meshRegistry.remove(mesh),
+                                 m_submittedFrames);
+}
+
 uint32_t VulkanRenderer::chooseSwapMinImageCount(
     const vk::SurfaceCapabilitiesKHR &surfaceCapabilities) {
     auto minImageCount = std::max(3u, surfaceCapabilities.minImageCount);
@@ -197,6 +272,8 @@ vk::raii::ShaderModule VulkanRenderer::createShaderModule(
 void VulkanRenderer::recordCommandBuffer(uint32_t imageIndex) {
     m_commandBuffers[m_currentFrame].begin({});
 
+    recordCullingPasses();
+
     // Before rendering, transition the swapchain image to
     // `eColorAttachmentOptimal`
     transitionImageLayout(imageIndex, vk::ImageLayout::eUndefined,
@@ -241,8 +318,15 @@ void VulkanRenderer::recordCommandBuffer(uint32_t imageIndex) {
             vk::PipelineBindPoint::eGraphics, m_pipelineLayout, 0,
             *m_descriptorSets[m_currentFrame], nullptr);
 
-        m_commandBuffers[m_currentFrame].drawIndexed(
-            static_cast<uint16_t>(m_indices.size()), 1, 0, 0, 0);
+        // One draw per batch with visible instances, as counted by the
+        // culling passes, so recording costs the same for any scene.
+        if (m_cullingConstants.batchCount > 0) {
+            const CullingBuffers &buffers = m_cullingBuffers[m_currentFrame];
+            m_commandBuffers[m_currentFrame].drawIndexedIndirectCount(
+                *buffers.drawCommands, 0, *buffers.drawCounts, 0,
+                m_cullingConstants.batchCount,
+                sizeof(vk::DrawIndexedIndirectCommand));
+        }
     }
 
     m_commandBuffers[m_currentFrame].endRendering();
@@ -257,43 +341,77 @@ void VulkanRenderer::recordCommandBuffer(uint32_t imageIndex) {
     m_commandBuffers[m_currentFrame].end();
 }
 
-void VulkanRenderer::transitionImageLayout(const vk::raii::Image &image,
-                                           vk::ImageLayout oldLayout,
-                                           vk::ImageLayout newLayout) {
-    vk::raii::CommandBuffer commandBuffer = beginSingleTimeCommands();
-
-    vk::ImageMemoryBarrier barrier =
-        vk::ImageMemoryBarrier()
-            .setOldLayout(oldLayout)
-            .setNewLayout(newLayout)
-            .setImage(image)
-            .setSubresourceRange(vk::ImageSubresourceRange(
-                vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1));
-
-    vk::PipelineStageFlags sourceStage;
-    vk::PipelineStageFlags destinationStage;
-
-    if (oldLayout == vk::ImageLayout::eUndefined &&
-        newLayout == vk::ImageLayout::eTransferDstOptimal) {
-        barrier.setSrcAccessMask({});
-        barrier.setDstAccessMask(vk::AccessFlagBits::eTransferWrite);
-
-        sourceStage = vk::PipelineStageFlagBits::eTopOfPipe;
-        destinationStage = vk::PipelineStageFlagBits::eTransfer;
-    } else if (oldLayout == vk::ImageLayout::eTransferDstOptimal &&
-               newLayout == vk::ImageLayout::eShaderReadOnlyOptimal) {
-        barrier.setSrcAccessMask(vk::AccessFlagBits::eTransferWrite);
-        barrier.setDstAccessMask(vk::AccessFlagBits::eShaderRead);
-
-        sourceStage = vk::PipelineStageFlagBits::eTransfer;
-        destinationStage = vk::PipelineStageFlagBits::eFragmentShader;
-    } else {
-        throw std::runtime_error("Error: Unsupported layout transition!\n");
+void VulkanRenderer::recordCullingPasses() {
+    if (m_cullingConstants.batchCount == 0) {
+        return;
     }
 
-    commandBuffer.pipelineBarrier(sourceStage, destinationStage, {}, {},
-                                  nullptr, barrier);
-    endSingleTimeCommands(commandBuffer);
+    const vk::raii::CommandBuffer &commandBuffer =
+        m_commandBuffers[m_currentFrame];
+    const CullingBuffers &buffers = m_cullingBuffers[m_currentFrame];
+
+    const auto memoryBarrier =
+        [&](const vk::PipelineStageFlags2 sourceStage,
+            const vk::AccessFlags2 sourceAccess,
+            const vk::PipelineStageFlags2 destinationStage,
+            const vk::AccessFlags2 destinationAccess) {
+            const vk::MemoryBarrier2 barrier =
+                vk::MemoryBarrier2()
+                    .setSrcStageMask(sourceStage)
+                    .setSrcAccessMask(sourceAccess)
+                    .setDstStageMask(destinationStage)
+                    .setDstAccessMask(destinationAccess);
+
+            commandBuffer.pipelineBarrier2(
+                vk::DependencyInfo()
+                    .setMemoryBarrierCount(1)
+                    .setPMemoryBarriers(&barrier));
+        };
+
+    // Zero the draw count and the visible instance count of every batch.
+    commandBuffer.fillBuffer(
+        *buffers.drawCounts, 0,
+        sizeof(uint32_t) * (1 + m_cullingConstants.batchCount), 0);
+    memoryBarrier(vk::PipelineStageFlagBits2::eTransfer,
+                  vk::AccessFlagBits2::eTransferWrite,
+                  vk::PipelineStageFlagBits2::eComputeShader,
+                  vk::AccessFlagBits2::eShaderStorageRead |
+                      vk::AccessFlagBits2::eShaderStorageWrite);
+
+    const std::array<vk::DescriptorSet, 2> descriptorSets = {
+        *m_descriptorSets[m_currentFrame],
+        *m_cullingDescriptorSets[m_currentFrame]};
+    commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eCompute,
+                                     m_cullingPipelineLayout, 0,
+                                     descriptorSets, nullptr);
+    commandBuffer.pushConstants<CullingConstants>(
+        *m_cullingPipelineLayout, vk::ShaderStageFlagBits::eCompute, 0,
+        m_cullingConstants);
+
+    commandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute,
+                               m_cullingPipeline);
+    commandBuffer.dispatch((m_cullingConstants.instanceCount +
+                            m_kCullingGroupSize - 1) /
+                               m_kCullingGroupSize,
+                           1, 1);
+    memoryBarrier(vk::PipelineStageFlagBits2::eComputeShader,
+                  vk::AccessFlagBits2::eShaderStorageWrite,
+                  vk::PipelineStageFlagBits2::eComputeShader,
+                  vk::AccessFlagBits2::eShaderStorageRead |
+                      vk::AccessFlagBits2::eShaderStorageWrite);
+
+    commandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute,
+                               m_compactionPipeline);
+    commandBuffer.dispatch((m_cullingConstants.batchCount +
+                            m_kCullingGroupSize - 1) /
+                               m_kCullingGroupSize,
+                           1, 1);
+    memoryBarrier(vk::PipelineStageFlagBits2::eComputeShader,
+                  vk::AccessFlagBits2::eShaderStorageWrite,
+                  vk::PipelineStageFlagBits2::eDrawIndirect |
+                      vk::PipelineStageFlagBits2::eVertexShader,
+                  vk::AccessFlagBits2::eIndirectCommandRead |
+                      vk::AccessFlagBits2::eShaderStorageRead);
 }
 
 void VulkanRenderer::transitionImageLayout(
@@ -340,96 +458,240 @@ void VulkanRenderer::recreateSwapchain() {
     createImageViews();
 }
 
-uint32_t VulkanRenderer::findMemoryType(uint32_t typeFilter,
-                                        vk::MemoryPropertyFlags properties) {
-    vk::PhysicalDeviceMemoryProperties memoryProperties =
-        m_physicalDevice.getMemoryProperties();
-    for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; ++i) {
-        // If there is a memory type suitable for the buffer that also has all
-        // the properties we need, then we return its index
-        if ((typeFilter & (1 << i)) &&
-            (memoryProperties.memoryTypes[i].propertyFlags & properties) ==
-                properties) {
-            return i;
-        }
-    }
-
-    throw std::runtime_error(
-        "[Vulkan] Error: Failed to find suitable memory type!\n");
-}
-
 void VulkanRenderer::createBuffer(vk::DeviceSize size,
                                   vk::BufferUsageFlags usage,
                                   vk::MemoryPropertyFlags properties,
                                   vk::raii::Buffer &buffer,
-                                  vk::raii::DeviceMemory &bufferMemory) {
+                                  VulkanAllocation &bufferMemory,
+                                  const VulkanResourceKind kind) {
     vk::BufferCreateInfo bufferInfo =
         vk::BufferCreateInfo().setSize(size).setUsage(usage).setSharingMode(
             vk::SharingMode::eExclusive);
 
     buffer = vk::raii::Buffer(m_logicalDevice, bufferInfo);
 
-    vk::MemoryRequirements memoryRequirements = buffer.getMemoryRequirements();
-    vk::MemoryAllocateInfo memoryAllocateInfo =
-        vk::MemoryAllocateInfo()
-            .setAllocationSize(memoryRequirements.size)
-            .setMemoryTypeIndex(
-                findMemoryType(memoryRequirements.memoryTypeBits, properties));
-
-    bufferMemory = vk::raii::DeviceMemory(m_logicalDevice, memoryAllocateInfo);
-    buffer.bindMemory(bufferMemory, 0);
+    bufferMemory = m_memoryAllocator->allocate(buffer.getMemoryRequirements(),
+                                               properties, kind);
+    buffer.bindMemory(bufferMemory.memory(), bufferMemory.offset());
 }
 
-void VulkanRenderer::copyBuffer(const vk::raii::Buffer &sourceBuffer,
-                                const vk::raii::Buffer &destinationBuffer,
-                                const vk::DeviceSize size) const {
-    const vk::raii::CommandBuffer commandCopyBuffer = beginSingleTimeCommands();
-    commandCopyBuffer.copyBuffer(sourceBuffer, destinationBuffer,
-                                 vk::BufferCopy(0, 0, size));
-    endSingleTimeCommands(commandCopyBuffer);
+void VulkanRenderer::growMeshBuffers() {
+    vk::raii::Buffer vertexBuffer({});
+    VulkanAllocation vertexBufferMemory;
+    createBuffer(sizeof(VulkanVertex) * m_meshRegistry.vertexCapacity(),
+                 vk::BufferUsageFlagBits::eTransferSrc |
+                     vk::BufferUsageFlagBits::eTransferDst |
+                     vk::BufferUsageFlagBits::eVertexBuffer,
+                 vk::MemoryPropertyFlagBits::eDeviceLocal, vertexBuffer,
+                 vertexBufferMemory);
+
+    vk::raii::Buffer indexBuffer({});
+    VulkanAllocation indexBufferMemory;
+    createBuffer(sizeof(uint16_t) * m_meshRegistry.indexCapacity(),
+                 vk::BufferUsageFlagBits::eTransferSrc |
+                     vk::BufferUsageFlagBits::eTransferDst |
+                     vk::BufferUsageFlagBits::eIndexBuffer,
+                 vk::MemoryPropertyFlagBits::eDeviceLocal, indexBuffer,
+                 indexBufferMemory);
+
+    // Frames in flight still read the old buffers, and recorded uploads may
+    // still write them.
+    if (m_vertexBufferCapacity > 0) {
+        m_uploader->copyBuffer(m_vertexBuffer, vertexBuffer,
+                               sizeof(VulkanVertex) * m_vertexBufferCapacity);
+        m_uploader->copyBuffer(m_indexBuffer, indexBuffer,
+                               sizeof(uint16_t) * m_indexBufferCapacity);
+        m_uploader->retire(std::move(m_vertexBuffer),
+                           std::move(m_vertexBufferMemory));
+        m_uploader->retire(std::move(m_indexBuffer),
+                           std::move(m_indexBufferMemory));
+    }
+
+    m_vertexBuffer = std::move(vertexBuffer);
+    m_vertexBufferMemory = std::move(vertexBufferMemory);
+    m_indexBuffer = std::move(indexBuffer);
+    m_indexBufferMemory = std::move(indexBufferMemory);
+    m_vertexBufferCapacity = m_meshRegistry.vertexCapacity();
+    m_indexBufferCapacity = m_meshRegistry.indexCapacity();
 }
 
-void VulkanRenderer::copyBufferToImage(const vk::raii::Buffer &buffer,
-                                       const vk::raii::Image &image,
-                                       const uint32_t width,
-                                       const uint32_t height) const {
-    const vk::raii::CommandBuffer commandBuffer = beginSingleTimeCommands();
-
-    vk::BufferImageCopy region =
-        vk::BufferImageCopy()
-            .setBufferOffset(0)
-            .setBufferRowLength(0)
-            .setBufferImageHeight(0)
-            .setImageSubresource(vk::ImageSubresourceLayers(
-                vk::ImageAspectFlagBits::eColor, 0, 0, 1))
-            .setImageOffset(vk::Offset3D(0, 0, 0))
-            .setImageExtent(vk::Extent3D(width, height, 1));
-
-    commandBuffer.copyBufferToImage(
-        buffer, image, vk::ImageLayout::eTransferDstOptimal, {region});
-
-    endSingleTimeCommands(commandBuffer);
+void VulkanRenderer::releaseRemovedMeshes() {
+    // Called once the fence of the frame about to be recorded has signalled:
+    // every frame but the last m_kFramesInFlight - 1 submitted has finished.
+    std::erase_if(m_removedMeshes, [this](const RemovedMesh &removed) {
+        if (removed.frame + m_kFramesInFlight - 1 > m_submittedFrames) {
+            return false;
+        }
+
+        m_meshRegistry.release(removed.range);
+        return true;
+    });
 }
 
-void VulkanRenderer::updateUniformBuffer(const uint32_t currentImage,
-                                         const glm::mat4 &viewMatrix) const {
+void VulkanRenderer::updateUniformBuffer(
+    const uint32_t currentImage, const glm::mat4 &viewMatrix,
+    const glm::mat4 &projectionMatrix) const {
     UniformBufferObject ubo{};
-    ubo.model = glm::mat4(1.0f);
-    // ubo.model = glm::rotate(ubo.model, glm::radians(90.0f), glm::vec3(0, 1,
-    // 0));
-
     ubo.view = viewMatrix;
 
-    ubo.projection =
-        glm::perspective(glm::radians(45.0f),
-                         static_cast<float>(m_swapchainExtent.width) /
-                             static_cast<float>(m_swapchainExtent.height),
-                         0.1f, 10.f);
+    ubo.projection = projectionMatrix;
 
     // Flipping Y coordinate of clip coordinates to match Vulkan's
     ubo.projection[1][1] *= -1;
 
-    memcpy(m_uniformBuffersMapped[currentImage], &ubo, sizeof(ubo));
+    memcpy(m_uniformBuffersMemory[currentImage].mapped(), &ubo, sizeof(ubo));
+}
+
+void VulkanRenderer::updateCullingBuffers(const uint32_t currentImage) {
+    const std::span<const MeshHandle> meshes = m_frustumCuller.meshes();
+    const std::span<const glm::mat4> worldMatrices =
+        m_frustumCuller.worldMatrices();
+    const scene::CullingBoundsArrays bounds = m_frustumCuller.bounds();
+    CullingBuffers &buffers = m_cullingBuffers[currentImage];
+
+    // The fence of this frame has signalled, so nothing reads its culling
+    // buffers or descriptor sets while they are replaced.
+    bool isGrown = false;
+    if (meshes.size() > buffers.instanceCapacity) {
+        createCullingInstanceBuffers(
+            currentImage, std::bit_ceil(static_cast<uint32_t>(meshes.size())));
+        isGrown = true;
+    }
+
+    constexpr uint32_t kNoBatch = UINT32_MAX;
+    m_cullingBatches.clear();
+    m_meshBatches.assign(m_meshRegistry.slotCount(), kNoBatch);
+
+    // Instances keep their gathered order. Until the batches are laid out
+    // below, each batch's firstInstance counts its instances.
+    auto *instances =
+        static_cast<CullingInstance *>(buffers.instancesMemory.mapped());
+    uint32_t instanceCount = 0;
+    for (std::size_t i = 0; i < meshes.size(); i++) {
+        if (!m_meshRegistry.isValid(meshes[i])) {
+            continue;
+        }
+
+        uint32_t &batch = m_meshBatches[meshes[i].index];
+        if (batch == kNoBatch) {
+            const MeshRange &range = m_meshRegistry.range(meshes[i]);
+            batch = static_cast<uint32_t>(m_cullingBatches.size());
+            m_cullingBatches.emplace_back(CullingBatch{
+                range.indexCount, range.firstIndex,
+                static_cast<int32_t>(range.firstVertex), 0});
+        }
+
+        m_cullingBatches[batch].firstInstance++;
+        instances[instanceCount++] = CullingInstance{
+            worldMatrices[i],
+            glm::vec3(bounds.centerX[i], bounds.centerY[i], bounds.centerZ[i]),
+            batch,
+            glm::vec3(bounds.extentX[i], bounds.extentY[i], bounds.extentZ[i]),
+            0};
+    }
+
+    uint32_t firstInstance = 0;
+    for (CullingBatch &batch : m_cullingBatches) {
+        const uint32_t batchInstanceCount = batch.firstInstance;
+        batch.firstInstance = firstInstance;
+        firstInstance += batchInstanceCount;
+    }
+
+    const auto batchCount = static_cast<uint32_t>(m_cullingBatches.size());
+    if (batchCount > buffers.batchCapacity) {
+        createCullingBatchBuffers(currentImage, std::bit_ceil(batchCount));
+        isGrown = true;
+    }
+
+    if (isGrown) {
+        writeCullingDescriptors(currentImage);
+    }
+
+    std::ranges::copy(m_cullingBatches, static_cast<CullingBatch *>(
+                                            buffers.batchesMemory.mapped()));
+
+    std::ranges::copy(m_frustumCuller.frustum().planes,
+                      m_cullingConstants.planes.begin());
+    m_cullingConstants.instanceCount = instanceCount;
+    m_cullingConstants.batchCount = batchCount;
+}
+
+void VulkanRenderer::createCullingInstanceBuffers(const uint32_t currentImage,
+                                                  const uint32_t capacity) {
+    CullingBuffers &buffers = m_cullingBuffers[currentImage];
+
+    createBuffer(sizeof(CullingInstance) * capacity,
+                 vk::BufferUsageFlagBits::eStorageBuffer,
+                 vk::MemoryPropertyFlagBits::eHostVisible |
+                     vk::MemoryPropertyFlagBits::eHostCoherent,
+                 buffers.instances, buffers.instancesMemory);
+    createBuffer(sizeof(glm::mat4) * capacity,
+                 vk::BufferUsageFlagBits::eStorageBuffer,
+                 vk::MemoryPropertyFlagBits::eDeviceLocal,
+                 buffers.visibleInstances, buffers.visibleInstancesMemory);
+
+    buffers.instanceCapacity = capacity;
+}
+
+void VulkanRenderer::createCullingBatchBuffers(const uint32_t currentImage,
+                                               const uint32_t capacity) {
+    CullingBuffers &buffers = m_cullingBuffers[currentImage];
+
+    createBuffer(sizeof(CullingBatch) * capacity,
+                 vk::BufferUsageFlagBits::eStorageBuffer,
+                 vk::MemoryPropertyFlagBits::eHostVisible |
+                     vk::MemoryPropertyFlagBits::eHostCoherent,
+                 buffers.batches, buffers.batchesMemory);
+    createBuffer(sizeof(uint32_t) * (1 + capacity),
+                 vk::BufferUsageFlagBits::eStorageBuffer |
+                     vk::BufferUsageFlagBits::eIndirectBuffer |
+                     vk::BufferUsageFlagBits::eTransferDst,
+                 vk::MemoryPropertyFlagBits::eDeviceLocal, buffers.drawCounts,
+                 buffers.drawCountsMemory);
+    createBuffer(sizeof(vk::DrawIndexedIndirectCommand) * capacity,
+                 vk::BufferUsageFlagBits::eStorageBuffer |
+                     vk::BufferUsageFlagBits::eIndirectBuffer,
+                 vk::MemoryPropertyFlagBits::eDeviceLocal,
+                 buffers.drawCommands, buffers.drawCommandsMemory);
+
+    buffers.batchCapacity = capacity;
+}
+
+void VulkanRenderer::writeCullingDescriptors(const uint32_t currentImage) {
+    const CullingBuffers &buffers = m_cullingBuffers[currentImage];
+
+    // In binding order of the culling set.
+    const std::array<vk::DescriptorBufferInfo, 5> bufferInfos = {
+        vk::DescriptorBufferInfo(*buffers.instances, 0, vk::WholeSize),
+        vk::DescriptorBufferInfo(*buffers.batches, 0, vk::WholeSize),
+        vk::DescriptorBufferInfo(*buffers.visibleInstances, 0, vk::WholeSize),
+        vk::DescriptorBufferInfo(*buffers.drawCounts, 0, vk::WholeSize),
+        vk::DescriptorBufferInfo(*buffers.drawCommands, 0, vk::WholeSize)};
+
+    // The vertex shader reads the visible instances at binding 2 of set 0.
+    std::array<vk::WriteDescriptorSet, bufferInfos.size() + 1>
+        descriptorWrites;
+    descriptorWrites[0] =
+        vk::WriteDescriptorSet()
+            .setDstSet(m_descriptorSets[currentImage])
+            .setDstBinding(2)
+            .setDstArrayElement(0)
+            .setDescriptorCount(1)
+            .setDescriptorType(vk::DescriptorType::eStorageBuffer)
+            .setPBufferInfo(&bufferInfos[2]);
+
+    for (uint32_t binding = 0; binding < bufferInfos.size(); binding++) {
+        descriptorWrites[binding + 1] =
+            vk::WriteDescriptorSet()
+                .setDstSet(m_cullingDescriptorSets[currentImage])
+                .setDstBinding(binding)
+                .setDstArrayElement(0)
+                .setDescriptorCount(1)
+                .setDescriptorType(vk::DescriptorType::eStorageBuffer)
+                .setPBufferInfo(&bufferInfos[binding]);
+    }
+
+    m_logicalDevice.updateDescriptorSets(descriptorWrites, {});
 }
 
 std::vector<char> VulkanRenderer::readFile(const std::string &fileName) {
@@ -452,7 +714,7 @@ void VulkanRenderer::createImage(const uint32_t width, const uint32_t height,
                                  const vk::ImageUsageFlags usage,
                                  const vk::MemoryPropertyFlags properties,
                                  vk::raii::Image &image,
-                                 vk::raii::DeviceMemory &imageMemory) {
+                                 VulkanAllocation &imageMemory) {
     const vk::ImageCreateInfo imageInfo =
         vk::ImageCreateInfo()
             .setImageType(vk::ImageType::e2D)
@@ -467,46 +729,11 @@ void VulkanRenderer::createImage(const uint32_t width, const uint32_t height,
 
     image = vk::raii::Image(m_logicalDevice, imageInfo);
 
-    const vk::MemoryRequirements memoryRequirements =
-        image.getMemoryRequirements();
-    const vk::MemoryAllocateInfo memoryAllocInfo =
-        vk::MemoryAllocateInfo()
-            .setAllocationSize(memoryRequirements.size)
-            .setMemoryTypeIndex(
-                findMemoryType(memoryRequirements.memoryTypeBits, properties));
-
-    imageMemory = vk::raii::DeviceMemory(m_logicalDevice, memoryAllocInfo);
-    image.bindMemory(imageMemory, 0);
-}
-
-vk::raii::CommandBuffer VulkanRenderer::beginSingleTimeCommands() const {
-    const vk::CommandBufferAllocateInfo allocInfo =
-        vk::CommandBufferAllocateInfo()
-            .setCommandPool(m_commandPool)
-            .setLevel(vk::CommandBufferLevel::ePrimary)
-            .setCommandBufferCount(1);
-
-    vk::raii::CommandBuffer commandBuffer =
-        std::move(m_logicalDevice.allocateCommandBuffers(allocInfo).front());
-
-    constexpr vk::CommandBufferBeginInfo beginInfo =
-        vk::CommandBufferBeginInfo().setFlags(
-            vk::CommandBufferUsageFlagBits::eOneTimeSubmit);
-
-    commandBuffer.begin(beginInfo);
-
-    return commandBuffer;
-}
-
-void VulkanRenderer::endSingleTimeCommands(
-    const vk::raii::CommandBuffer &commandBuffer) const {
-    commandBuffer.end();
-
-    const vk::SubmitInfo submitInfo =
-        vk::SubmitInfo().setCommandBufferCount(1).setPCommandBuffers(
-            &*commandBuffer);
-    m_queue.submit(submitInfo, nullptr);
-    m_queue.waitIdle();
+    imageMemory = m_memoryAllocator->allocate(
+        image.getMemoryRequirements(), properties,
+        tiling == vk::ImageTiling::eOptimal ? VulkanResourceKind::eOptimalImage
+                                            : VulkanResourceKind::eLinear);
+    image.bindMemory(imageMemory.memory(), imageMemory.offset());
 }
 
 vk::raii::ImageView VulkanRenderer::createImageView(vk::raii::Image &image,
@@ -571,14 +798,22 @@ void VulkanRenderer::pickPhysicalDevice() {
 
             auto features = physicalDevice.template getFeatures2<
                 vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceVulkan11Features,
+                vk::PhysicalDeviceVulkan12Features,
                 vk::PhysicalDeviceVulkan13Features,
                 vk::PhysicalDeviceExtendedDynamicStateFeaturesEXT>();
 
+            // Culling on the GPU draws through drawIndexedIndirectCount.
             bool supportsRequiredFeatures =
                 features.template get<vk::PhysicalDeviceFeatures2>()
                     .features.samplerAnisotropy &&
+                features.template get<vk::PhysicalDeviceFeatures2>()
+                    .features.multiDrawIndirect &&
+                features.template get<vk::PhysicalDeviceFeatures2>()
+                    .features.drawIndirectFirstInstance &&
                 features.template get<vk::PhysicalDeviceVulkan11Features>()
                     .shaderDrawParameters &&
+                features.template get<vk::PhysicalDeviceVulkan12Features>()
+                    .drawIndirectCount &&
                 features.template get<vk::PhysicalDeviceVulkan13Features>()
                     .synchronization2 &&
                 features.template get<vk::PhysicalDeviceVulkan13Features>()
@@ -632,13 +867,19 @@ void VulkanRenderer::createLogicalDevice() {
     // Query for Vulkan 1.3+ features
     vk::StructureChain<vk::PhysicalDeviceFeatures2,
                        vk::PhysicalDeviceVulkan11Features,
+                       vk::PhysicalDeviceVulkan12Features,
                        vk::PhysicalDeviceVulkan13Features,
                        vk::PhysicalDeviceExtendedDynamicStateFeaturesEXT>
         featureChain(
-            vk::PhysicalDeviceFeatures2{}.features = {{.samplerAnisotropy =
-                                                           vk::True}},
+            vk::PhysicalDeviceFeatures2{}.features = {{
+                .multiDrawIndirect = vk::True,
+                .drawIndirectFirstInstance = vk::True,
+                .samplerAnisotropy = vk::True,
+            }},
             vk::PhysicalDeviceVulkan11Features{}.setShaderDrawParameters(
                 vk::True),
+            vk::PhysicalDeviceVulkan12Features{}.setDrawIndirectCount(
+                vk::True),
             vk::PhysicalDeviceVulkan13Features{}
                 .setDynamicRendering(vk::True)
                 .setSynchronization2(vk::True),
@@ -670,6 +911,12 @@ void VulkanRenderer::createLogicalDevice() {
                Debug::MessageSeverity::eInformation);
     Debug::log("[Vulkan] Created: Queue (Graphics and Presentation)",
                Debug::MessageSeverity::eInformation);
+
+    m_memoryAllocator = std::make_unique<VulkanMemoryAllocator>(
+        m_physicalDevice, m_logicalDevice);
+
+    Debug::log("[Vulkan] Created: Memory Allocator",
+               Debug::MessageSeverity::eInformation);
 }
 
 void VulkanRenderer::createSwapchain() {
@@ -727,13 +974,16 @@ void VulkanRenderer::createImageViews() {
 }
 
 void VulkanRenderer::createDescriptorSetLayout() {
-    std::array<vk::DescriptorSetLayoutBinding, 2> bindings = {
+    std::array<vk::DescriptorSetLayoutBinding, 3> bindings = {
         vk::DescriptorSetLayoutBinding(0, vk::DescriptorType::eUniformBuffer, 1,
                                        vk::ShaderStageFlagBits::eVertex,
                                        nullptr),
         vk::DescriptorSetLayoutBinding(
             1, vk::DescriptorType::eCombinedImageSampler, 1,
-            vk::ShaderStageFlagBits::eFragment, nullptr)};
+            vk::ShaderStageFlagBits::eFragment, nullptr),
+        vk::DescriptorSetLayoutBinding(2, vk::DescriptorType::eStorageBuffer, 1,
+                                       vk::ShaderStageFlagBits::eVertex,
+                                       nullptr)};
 
     const vk::DescriptorSetLayoutCreateInfo layoutInfo =
         vk::DescriptorSetLayoutCreateInfo()
@@ -745,6 +995,25 @@ void VulkanRenderer::createDescriptorSetLayout() {
 
     Debug::log("[Vulkan] Created: DescriptorSetLayout",
                Debug::MessageSeverity::eInformation);
+
+    // Instances, batches, visible instances, draw counts and draw commands.
+    std::array<vk::DescriptorSetLayoutBinding, 5> cullingBindings;
+    for (uint32_t binding = 0; binding < cullingBindings.size(); binding++) {
+        cullingBindings[binding] = vk::DescriptorSetLayoutBinding(
+            binding, vk::DescriptorType::eStorageBuffer, 1,
+            vk::ShaderStageFlagBits::eCompute, nullptr);
+    }
+
+    const vk::DescriptorSetLayoutCreateInfo cullingLayoutInfo =
+        vk::DescriptorSetLayoutCreateInfo()
+            .setBindingCount(cullingBindings.size())
+            .setPBindings(cullingBindings.data());
+
+    m_cullingDescriptorSetLayout =
+        vk::raii::DescriptorSetLayout(m_logicalDevice, cullingLayoutInfo);
+
+    Debug::log("[Vulkan] Created: DescriptorSetLayout (Culling)",
+               Debug::MessageSeverity::eInformation);
 }
 
 void VulkanRenderer::createGraphicsPipeline() {
@@ -766,8 +1035,8 @@ void VulkanRenderer::createGraphicsPipeline() {
     vk::PipelineShaderStageCreateInfo shaderStages[] = {
         vertexShaderStageInfo, fragmentShaderStageInfo};
 
-    auto bindingDescription = Vertex::getBindingDescription();
-    auto attributeDescriptions = Vertex::getAttributeDescriptions();
+    auto bindingDescription = VulkanVertex::getBindingDescription();
+    auto attributeDescriptions = VulkanVertex::getAttributeDescriptions();
     vk::PipelineVertexInputStateCreateInfo vertexInputInfo =
         vk::PipelineVertexInputStateCreateInfo()
             .setVertexBindingDescriptionCount(1)
@@ -824,8 +1093,7 @@ void VulkanRenderer::createGraphicsPipeline() {
     vk::PipelineLayoutCreateInfo pipelineLayoutInfo =
         vk::PipelineLayoutCreateInfo()
             .setSetLayoutCount(1)
-            .setPSetLayouts(&*m_descriptorSetLayout)
-            .setPushConstantRangeCount(0);
+            .setPSetLayouts(&*m_descriptorSetLayout);
 
     m_pipelineLayout =
         vk::raii::PipelineLayout(m_logicalDevice, pipelineLayoutInfo);
@@ -864,6 +1132,49 @@ void VulkanRenderer::createGraphicsPipeline() {
                Debug::MessageSeverity::eInformation);
 }
 
+void VulkanRenderer::createCullingPipelines() {
+    auto shaderCode = readFile("shaders/shader.spv");
+    vk::raii::ShaderModule shaderModule = createShaderModule(shaderCode);
+
+    vk::PushConstantRange pushConstantRange(vk::ShaderStageFlagBits::eCompute,
+                                            0, sizeof(CullingConstants));
+
+    const std::array<vk::DescriptorSetLayout, 2> setLayouts = {
+        *m_descriptorSetLayout, *m_cullingDescriptorSetLayout};
+
+    vk::PipelineLayoutCreateInfo pipelineLayoutInfo =
+        vk::PipelineLayoutCreateInfo()
+            .setSetLayoutCount(setLayouts.size())
+            .setPSetLayouts(setLayouts.data())
+            .setPushConstantRangeCount(1)
+            .setPPushConstantRanges(&pushConstantRange);
+
+    m_cullingPipelineLayout =
+        vk::raii::PipelineLayout(m_logicalDevice, pipelineLayoutInfo);
+
+    Debug::log("[Vulkan] Created: Pipeline Layout (Culling)",
+               Debug::MessageSeverity::eInformation);
+
+    const auto createComputePipeline = [&](const char *entryPoint) {
+        const vk::ComputePipelineCreateInfo computePipelineInfo =
+            vk::ComputePipelineCreateInfo()
+                .setStage(vk::PipelineShaderStageCreateInfo()
+                              .setStage(vk::ShaderStageFlagBits::eCompute)
+                              .setModule(shaderModule)
+                              .setPName(entryPoint))
+                .setLayout(m_cullingPipelineLayout);
+
+        return vk::raii::Pipeline(m_logicalDevice, nullptr,
+                                  computePipelineInfo);
+    };
+
+    m_cullingPipeline = createComputePipeline("cullMain");
+    m_compactionPipeline = createComputePipeline("compactMain");
+
+    Debug::log("[Vulkan] Created: Pipelines (Culling)",
+               Debug::MessageSeverity::eInformation);
+}
+
 void VulkanRenderer::createCommandPool() {
     vk::CommandPoolCreateInfo poolInfo =
         vk::CommandPoolCreateInfo()
@@ -876,6 +1187,14 @@ void VulkanRenderer::createCommandPool() {
                Debug::MessageSeverity::eInformation);
 }
 
+void VulkanRenderer::createUploader() {
+    m_uploader = std::make_unique<VulkanUploader>(
+        m_logicalDevice, m_queue, m_queueIndex, *m_memoryAllocator);
+
+    Debug::log("[Vulkan] Created: Uploader",
+               Debug::MessageSeverity::eInformation);
+}
+
 void VulkanRenderer::createTextureImage() {
     int textureWidth;
     int textureHeight;
@@ -891,20 +1210,6 @@ void VulkanRenderer::createTextureImage() {
             "Error: Failed to load parrot texture image!\n");
     }
 
-    vk::raii::Buffer stagingBuffer({});
-    vk::raii::DeviceMemory stagingBufferMemory({});
-
-    createBuffer(imageSize, vk::BufferUsageFlagBits::eTransferSrc,
-                 vk::MemoryPropertyFlagBits::eHostVisible |
-                     vk::MemoryPropertyFlagBits::eHostCoherent,
-                 stagingBuffer, stagingBufferMemory);
-
-    void *data = stagingBufferMemory.mapMemory(0, imageSize);
-    memcpy(data, pixels, imageSize);
-    stagingBufferMemory.unmapMemory();
-
-    stbi_image_free(pixels);
-
     createImage(
         textureWidth, textureHeight, vk::Format::eR8G8B8A8Srgb,
         vk::ImageTiling::eOptimal,
@@ -912,13 +1217,11 @@ void VulkanRenderer::createTextureImage() {
         vk::MemoryPropertyFlagBits::eDeviceLocal, m_textureImage,
         m_textureImageMemory);
 
-    transitionImageLayout(m_textureImage, vk::ImageLayout::eUndefined,
-                          vk::ImageLayout::eTransferDstOptimal);
-    copyBufferToImage(stagingBuffer, m_textureImage,
-                      static_cast<uint32_t>(textureWidth),
-                      static_cast<uint32_t>(textureHeight));
-    transitionImageLayout(m_textureImage, vk::ImageLayout::eTransferDstOptimal,
-                          vk::ImageLayout::eShaderReadOnlyOptimal);
+    m_uploader->uploadImage(pixels, imageSize, m_textureImage,
+                            static_cast<uint32_t>(textureWidth),
+                            static_cast<uint32_t>(textureHeight));
+
+    stbi_image_free(pixels);
 
     Debug::log("[Vulkan] Created: Texture Image",
                Debug::MessageSeverity::eInformation);
@@ -955,62 +1258,21 @@ void VulkanRenderer::createTextureSampler() {
                Debug::MessageSeverity::eInformation);
 }
 
-void VulkanRenderer::createVertexBuffer() {
-    // Create temporary host-visible staging buffer
-    vk::DeviceSize bufferSize = sizeof(m_vertices[0]) * m_vertices.size();
-    vk::raii::Buffer stagingBuffer({});
-    vk::raii::DeviceMemory stagingBufferMemory({});
-
-    createBuffer(bufferSize, vk::BufferUsageFlagBits::eTransferSrc,
-                 vk::MemoryPropertyFlagBits::eHostVisible |
-                     vk::MemoryPropertyFlagBits::eHostCoherent,
-                 stagingBuffer, stagingBufferMemory);
-
-    void *stagingData = stagingBufferMemory.mapMemory(0, bufferSize);
-    memcpy(stagingData, m_vertices.data(), bufferSize);
-    stagingBufferMemory.unmapMemory();
-
-    createBuffer(bufferSize,
-                 vk::BufferUsageFlagBits::eTransferDst |
-                     vk::BufferUsageFlagBits::eVertexBuffer,
-                 vk::MemoryPropertyFlagBits::eDeviceLocal, m_vertexBuffer,
-                 m_vertexBufferMemory);
-
-    copyBuffer(stagingBuffer, m_vertexBuffer, bufferSize);
-}
+void VulkanRenderer::createMeshBuffers() {
+    growMeshBuffers();
 
-void VulkanRenderer::createIndexBuffer() {
-    vk::DeviceSize bufferSize = sizeof(m_indices[0]) * m_indices.size();
-
-    vk::raii::Buffer stagingBuffer({});
-    vk::raii::DeviceMemory stagingBufferMemory({});
-    createBuffer(bufferSize, vk::BufferUsageFlagBits::eTransferSrc,
-                 vk::MemoryPropertyFlagBits::eHostVisible |
-                     vk::MemoryPropertyFlagBits::eHostCoherent,
-                 stagingBuffer, stagingBufferMemory);
-
-    void *data = stagingBufferMemory.mapMemory(0, bufferSize);
-    memcpy(data, m_indices.data(), static_cast<size_t>(bufferSize));
-    stagingBufferMemory.unmapMemory();
-
-    createBuffer(bufferSize,
-                 vk::BufferUsageFlagBits::eTransferDst |
-                     vk::BufferUsageFlagBits::eIndexBuffer,
-                 vk::MemoryPropertyFlagBits::eDeviceLocal, m_indexBuffer,
-                 m_indexBufferMemory);
-
-    copyBuffer(stagingBuffer, m_indexBuffer, bufferSize);
+    Debug::log("[Vulkan] Created: Mesh Buffers",
+               Debug::MessageSeverity::eInformation);
 }
 
 void VulkanRenderer::createUniformBuffers() {
     m_uniformBuffers.clear();
     m_uniformBuffersMemory.clear();
-    m_uniformBuffersMapped.clear();
 
     for (size_t i = 0; i < m_kFramesInFlight; ++i) {
         vk::DeviceSize bufferSize = sizeof(UniformBufferObject);
         vk::raii::Buffer buffer({});
-        vk::raii::DeviceMemory bufferMemory({});
+        VulkanAllocation bufferMemory;
 
         createBuffer(bufferSize, vk::BufferUsageFlagBits::eUniformBuffer,
                      vk::MemoryPropertyFlagBits::eHostVisible |
@@ -1019,22 +1281,36 @@ void VulkanRenderer::createUniformBuffers() {
 
         m_uniformBuffers.emplace_back(std::move(buffer));
         m_uniformBuffersMemory.emplace_back(std::move(bufferMemory));
-        m_uniformBuffersMapped.emplace_back(
-            m_uniformBuffersMemory[i].mapMemory(0, bufferSize));
     }
 }
 
+void VulkanRenderer::createCullingBuffers() {
+    m_cullingBuffers.clear();
+    m_cullingBuffers.resize(m_kFramesInFlight);
+
+    for (uint32_t i = 0; i < m_kFramesInFlight; ++i) {
+        createCullingInstanceBuffers(i, m_kInitialCullingInstanceCapacity);
+        createCullingBatchBuffers(i, m_kInitialCullingBatchCapacity);
+    }
+
+    Debug::log("[Vulkan] Created: Culling Buffers",
+               Debug::MessageSeverity::eInformation);
+}
+
 void VulkanRenderer::createDescriptorPool() {
-    std::array<vk::DescriptorPoolSize, 2> poolSize = {
+    std::array<vk::DescriptorPoolSize, 3> poolSize = {
         vk::DescriptorPoolSize(vk::DescriptorType::eUniformBuffer,
                                m_kFramesInFlight),
         vk::DescriptorPoolSize(vk::DescriptorType::eCombinedImageSampler,
-                               m_kFramesInFlight)};
+                               m_kFramesInFlight),
+        // Visible instances in set 0, and the five culling buffers in set 1.
+        vk::DescriptorPoolSize(vk::DescriptorType::eStorageBuffer,
+                               6 * m_kFramesInFlight)};
 
     vk::DescriptorPoolCreateInfo poolInfo =
         vk::DescriptorPoolCreateInfo()
             .setFlags(vk::DescriptorPoolCreateFlagBits::eFreeDescriptorSet)
-            .setMaxSets(m_kFramesInFlight)
+            .setMaxSets(2 * m_kFramesInFlight)
             .setPoolSizeCount(poolSize.size())
             .setPPoolSizes(poolSize.data());
 
@@ -1056,6 +1332,19 @@ void VulkanRenderer::createDescriptorSets() {
     m_descriptorSets.clear();
     m_descriptorSets = m_logicalDevice.allocateDescriptorSets(allocInfo);
 
+    std::vector<vk::DescriptorSetLayout> cullingLayouts(
+        m_kFramesInFlight, *m_cullingDescriptorSetLayout);
+    vk::DescriptorSetAllocateInfo cullingAllocInfo =
+        vk::DescriptorSetAllocateInfo()
+            .setDescriptorPool(m_descriptorPool)
+            .setDescriptorSetCount(
+                static_cast<uint32_t>(cullingLayouts.size()))
+            .setPSetLayouts(cullingLayouts.data());
+
+    m_cullingDescriptorSets.clear();
+    m_cullingDescriptorSets =
+        m_logicalDevice.allocateDescriptorSets(cullingAllocInfo);
+
     for (size_t i = 0; i < m_kFramesInFlight; ++i) {
         vk::DescriptorBufferInfo bufferInfo =
             vk::DescriptorBufferInfo()
@@ -1087,6 +1376,7 @@ void VulkanRenderer::createDescriptorSets() {
                 .setPImageInfo(&imageInfo)};
 
         m_logicalDevice.updateDescriptorSets(descriptorWrites, {});
+        writeCullingDescriptors(static_cast<uint32_t>(i));
     }
 
     Debug::log("[Vulkan] Created: DescriptorSets",
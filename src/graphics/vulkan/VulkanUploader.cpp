@@ -0,0 +1,311 @@
+#include "avenir/graphics/vulkan/VulkanUploader.hpp"
+
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+namespace avenir::graphics::vulkan {
+
+namespace {
+
+void transitionImage(const vk::raii::CommandBuffer &commandBuffer,
+                     const vk::raii::Image &image, vk::ImageLayout oldLayout,
+                     vk::ImageLayout newLayout,
+                     vk::PipelineStageFlags2 sourceStageMask,
+                     vk::AccessFlags2 sourceAccessMask,
+                     vk::PipelineStageFlags2 destinationStageMask,
+                     vk::AccessFlags2 destinationAccessMask) {
+    const vk::ImageMemoryBarrier2 barrier =
+        vk::ImageMemoryBarrier2()
+            .setSrcStageMask(sourceStageMask)
+            .setSrcAccessMask(sourceAccessMask)
+            .setDstStageMask(destinationStageMask)
+            .setDstAccessMask(destinationAccessMask)
+            .setOldLayout(oldLayout)
+            .setNewLayout(newLayout)
+            .setSrcQueueFamilyIndex(vk::QueueFamilyIgnored)
+            .setDstQueueFamilyIndex(vk::QueueFamilyIgnored)
+            .setImage(image)
+            .setSubresourceRange(vk::ImageSubresourceRange(
+                vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1));
+
+    commandBuffer.pipelineBarrier2(vk::DependencyInfo()
+                                       .setImageMemoryBarrierCount(1)
+                                       .setPImageMemoryBarriers(&barrier));
+}
+
+void memoryBarrier(const vk::raii::CommandBuffer &commandBuffer,
+                   vk::PipelineStageFlags2 destinationStageMask,
+                   vk::AccessFlags2 destinationAccessMask) {
+    const vk::MemoryBarrier2 barrier =
+        vk::MemoryBarrier2()
+            .setSrcStageMask(vk::PipelineStageFlagBits2::eTransfer)
+            .setSrcAccessMask(vk::AccessFlagBits2::eTransferWrite)
+            .setDstStageMask(destinationStageMask)
+            .setDstAccessMask(destinationAccessMask);
+
+    commandBuffer.pipelineBarrier2(
+        vk::DependencyInfo().setMemoryBarrierCount(1).setPMemoryBarriers(
+            &barrier));
+}
+
+}  // namespace
+
+VulkanUploader::VulkanUploader(const vk::raii::Device &logicalDevice,
+                               const vk::raii::Queue &queue,
+                               const uint32_t queueFamilyIndex,
+                               VulkanMemoryAllocator &memoryAllocator,
+                               const vk::DeviceSize ringSize)
+    : m_logicalDevice(logicalDevice),
+      m_queue(queue),
+      m_memoryAllocator(memoryAllocator),
+      m_ringSize(ringSize) {
+    if (ringSize == 0 || ringSize % kStagingAlignment != 0) {
+        throw std::runtime_error(
+            "[Vulkan] Error: Staging ring size must be a non-zero multiple "
+            "of the staging alignment!\n");
+    }
+
+    const vk::CommandPoolCreateInfo poolInfo =
+        vk::CommandPoolCreateInfo()
+            .setFlags(vk::CommandPoolCreateFlagBits::eTransient |
+                      vk::CommandPoolCreateFlagBits::eResetCommandBuffer)
+            .setQueueFamilyIndex(queueFamilyIndex);
+
+    m_commandPool = vk::raii::CommandPool(m_logicalDevice, poolInfo);
+
+    const vk::BufferCreateInfo bufferInfo =
+        vk::BufferCreateInfo()
+            .setSize(ringSize)
+            .setUsage(vk::BufferUsageFlagBits::eTransferSrc)
+            .setSharingMode(vk::SharingMode::eExclusive);
+
+    m_ringBuffer = vk::raii::Buffer(m_logicalDevice, bufferInfo);
+    m_ringMemory = m_memoryAllocator.allocate(
+        m_ringBuffer.getMemoryRequirements(),
+        vk::MemoryPropertyFlagBits::eHostVisible |
+            vk::MemoryPropertyFlagBits::eHostCoherent,
+        VulkanResourceKind::eLinear);
+    m_ringBuffer.bindMemory(m_ringMemory.memory(), m_ringMemory.offset());
+}
+
+VulkanUploader::~VulkanUploader() {
+    while (!m_submittedBatches.empty()) {
+        waitForOldestBatch();
+    }
+}
+
+void VulkanUploader::uploadBuffer(const void *data, const vk::DeviceSize size,
+                                  const vk::raii::Buffer &destinationBuffer,
+                                  const vk::DeviceSize destinationOffset) {
+    const StagedData staged = stage(data, size);
+
+    recordingCommandBuffer().copyBuffer(
+        staged.buffer, *destinationBuffer,
+        vk::BufferCopy(staged.offset, destinationOffset, size));
+}
+
+void VulkanUploader::uploadImage(const void *data, const vk::DeviceSize size,
+                                 const vk::raii::Image &image,
+                                 const uint32_t width, const uint32_t height) {
+    const StagedData staged = stage(data, size);
+    const vk::raii::CommandBuffer &commandBuffer = recordingCommandBuffer();
+
+    transitionImage(commandBuffer, image, vk::ImageLayout::eUndefined,
+                    vk::ImageLayout::eTransferDstOptimal,
+                    vk::PipelineStageFlagBits2::eNone, {},
+                    vk::PipelineStageFlagBits2::eTransfer,
+                    vk::AccessFlagBits2::eTransferWrite);
+
+    const vk::BufferImageCopy region =
+        vk::BufferImageCopy()
+            .setBufferOffset(staged.offset)
+            .setBufferRowLength(0)
+            .setBufferImageHeight(0)
+            .setImageSubresource(vk::ImageSubresourceLayers(
+                vk::ImageAspectFlagBits::eColor, 0, 0, 1))
+            .setImageOffset(vk::Offset3D(0, 0, 0))
+            .setImageExtent(vk::Extent3D(width, height, 1));
+
+    commandBuffer.copyBufferToImage(staged.buffer, *image,
+                                    vk::ImageLayout::eTransferDstOptimal,
+                                    {region});
+
+    transitionImage(commandBuffer, image, vk::ImageLayout::eTransferDstOptimal,
+                    vk::ImageLayout::eShaderReadOnlyOptimal,
+                    vk::PipelineStageFlagBits2::eTransfer,
+                    vk::AccessFlagBits2::eTransferWrite,
+                    vk::PipelineStageFlagBits2::eFragmentShader,
+                    vk::AccessFlagBits2::eShaderSampledRead);
+}
+
+void VulkanUploader::copyBuffer(const vk::raii::Buffer &sourceBuffer,
+                                const vk::raii::Buffer &destinationBuffer,
+                                const vk::DeviceSize size) {
+    const vk::raii::CommandBuffer &commandBuffer = recordingCommandBuffer();
+
+    // Uploads recorded earlier may target the source.
+    memoryBarrier(commandBuffer, vk::PipelineStageFlagBits2::eTransfer,
+                  vk::AccessFlagBits2::eTransferRead);
+    commandBuffer.copyBuffer(*sourceBuffer, *destinationBuffer,
+                             vk::BufferCopy(0, 0, size));
+}
+
+void VulkanUploader::retire(vk::raii::Buffer buffer, VulkanAllocation memory) {
+    // The batch's fence also covers everything submitted before it.
+    static_cast<void>(recordingCommandBuffer());
+    m_recording.retired.emplace_back(std::move(buffer), std::move(memory));
+}
+
+void VulkanUploader::submit() {
+    if (!m_isRecording) {
+        reclaimCompletedBatches();
+        return;
+    }
+
+    memoryBarrier(m_recording.commandBuffer,
+                  vk::PipelineStageFlagBits2::eAllCommands,
+                  vk::AccessFlagBits2::eMemoryRead);
+    m_recording.commandBuffer.end();
+    m_recording.ringEnd = m_ringHead;
+
+    const vk::SubmitInfo submitInfo =
+        vk::SubmitInfo().setCommandBufferCount(1).setPCommandBuffers(
+            &*m_recording.commandBuffer);
+    m_queue.submit(submitInfo, *m_recording.fence);
+
+    m_submittedBatches.emplace_back(std::move(m_recording));
+    m_recording = Batch{};
+    m_isRecording = false;
+
+    reclaimCompletedBatches();
+}
+
+VulkanUploader::StagedData VulkanUploader::stage(const void *data,
+                                                 const vk::DeviceSize size) {
+    if (size > m_ringSize) {
+        RetiredBuffer staging;
+        const vk::BufferCreateInfo bufferInfo =
+            vk::BufferCreateInfo()
+                .setSize(size)
+                .setUsage(vk::BufferUsageFlagBits::eTransferSrc)
+                .setSharingMode(vk::SharingMode::eExclusive);
+
+        staging.buffer = vk::raii::Buffer(m_logicalDevice, bufferInfo);
+        staging.memory = m_memoryAllocator.allocate(
+            staging.buffer.getMemoryRequirements(),
+            vk::MemoryPropertyFlagBits::eHostVisible |
+                vk::MemoryPropertyFlagBits::eHostCoherent,
+            VulkanResourceKind::eTransient);
+        staging.buffer.bindMemory(staging.memory.memory(),
+                                  staging.memory.offset());
+        memcpy(staging.memory.mapped(), data, static_cast<size_t>(size));
+
+        const vk::Buffer buffer = *staging.buffer;
+        retire(std::move(staging.buffer), std::move(staging.memory));
+
+        return {buffer, 0};
+    }
+
+    reclaimCompletedBatches();
+
+    uint64_t position;
+    while (!tryReserve(size, position)) {
+        // Only the batch being recorded holds ring space; flush it so there
+        // is something to wait for.
+        if (m_submittedBatches.empty()) {
+            submit();
+        }
+
+        waitForOldestBatch();
+    }
+
+    const vk::DeviceSize offset = position % m_ringSize;
+    memcpy(static_cast<std::byte *>(m_ringMemory.mapped()) + offset, data,
+           static_cast<size_t>(size));
+
+    return {*m_ringBuffer, offset};
+}
+
+bool VulkanUploader::tryReserve(const vk::DeviceSize size,
+                                uint64_t &position) {
+    if (m_submittedBatches.empty() && m_ringTail == m_ringHead) {
+        m_ringTail = 0;
+        m_ringHead = 0;
+    }
+
+    position = (m_ringHead + kStagingAlignment - 1) & ~(kStagingAlignment - 1);
+
+    // Data never wraps around the end of the ring; skip to its start.
+    if (position % m_ringSize + size > m_ringSize) {
+        position = (position / m_ringSize + 1) * m_ringSize;
+    }
+
+    if (position + size - m_ringTail > m_ringSize) {
+        return false;
+    }
+
+    m_ringHead = position + size;
+
+    return true;
+}
+
+const vk::raii::CommandBuffer &VulkanUploader::recordingCommandBuffer() {
+    if (m_isRecording) {
+        return m_recording.commandBuffer;
+    }
+
+    if (!m_idleBatches.empty()) {
+        m_recording = std::move(m_idleBatches.back());
+        m_idleBatches.pop_back();
+    } else {
+        const vk::CommandBufferAllocateInfo allocInfo =
+            vk::CommandBufferAllocateInfo()
+                .setCommandPool(m_commandPool)
+                .setLevel(vk::CommandBufferLevel::ePrimary)
+                .setCommandBufferCount(1);
+
+        m_recording.commandBuffer = std::move(
+            m_logicalDevice.allocateCommandBuffers(allocInfo).front());
+        m_recording.fence =
+            vk::raii::Fence(m_logicalDevice, vk::FenceCreateInfo());
+    }
+
+    m_recording.commandBuffer.begin(vk::CommandBufferBeginInfo().setFlags(
+        vk::CommandBufferUsageFlagBits::eOneTimeSubmit));
+    m_isRecording = true;
+
+    return m_recording.commandBuffer;
+}
+
+void VulkanUploader::reclaimCompletedBatches() {
+    while (!m_submittedBatches.empty() &&
+           m_submittedBatches.front().fence.getStatus() ==
+               vk::Result::eSuccess) {
+        Batch &batch = m_submittedBatches.front();
+        m_ringTail = batch.ringEnd;
+        batch.retired.clear();
+        m_logicalDevice.resetFences(*batch.fence);
+        batch.commandBuffer.reset();
+
+        m_idleBatches.emplace_back(std::move(batch));
+        m_submittedBatches.pop_front();
+    }
+}
+
+void VulkanUploader::waitForOldestBatch() {
+    if (m_submittedBatches.empty()) {
+        return;
+    }
+
+    while (vk::Result::eTimeout ==
+           m_logicalDevice.waitForFences(*m_submittedBatches.front().fence,
+                                         vk::True, UINT64_MAX)) {
+        ;
+    }
+
+    reclaimCompletedBatches();
+}
+
+}  // namespace avenir::graphics::vulkan
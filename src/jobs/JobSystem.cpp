@@ -0,0 +1,239 @@
+#include "avenir/jobs/JobSystem.hpp"
+
+namespace avenir::jobs {
+
+namespace {
+
+// Identifies the pool worker running on this thread, if any.
+thread_local const JobSystem *t_jobSystem = nullptr;
+thread_local uint32_t t_workerIndex = 0;
+
+}  // namespace
+
+bool Counter::isDone() const {
+    if (m_pending.load(std::memory_order_acquire) != 0) {
+        return false;
+    }
+
+    // Wait out a finishing job that may still hold the lock.
+    std::scoped_lock lock(m_mutex);
+    return m_pending.load(std::memory_order_relaxed) == 0;
+}
+
+JobSystem::JobSystem()
+    : JobSystem(std::max(1u, std::thread::hardware_concurrency()) - 1) {}
+
+JobSystem::JobSystem(const uint32_t workerCount)
+    : m_mainThread(std::this_thread::get_id()) {
+    m_workers.reserve(workerCount);
+    for (uint32_t index = 0; index < workerCount; index++) {
+        m_workers.emplace_back(std::make_unique<Worker>());
+    }
+
+    m_threads.reserve(workerCount);
+    for (uint32_t index = 0; index < workerCount; index++) {
+        m_threads.emplace_back(
+            [this, index](const std::stop_token &stopToken) {
+                workerLoop(stopToken, index);
+            });
+    }
+}
+
+JobSystem::~JobSystem() {
+    // Request stop and join before the queues the workers use go away.
+    m_threads.clear();
+}
+
+JobSystem &JobSystem::shared() {
+    static JobSystem jobSystem;
+    return jobSystem;
+}
+
+void JobSystem::run(Job job, Counter *counter) {
+    if (counter) {
+        counter->m_pending.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    submit({std::move(job), counter});
+}
+
+void JobSystem::runAfter(Counter &dependency, Job job, Counter *counter) {
+    if (counter) {
+        counter->m_pending.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    {
+        std::scoped_lock lock(dependency.m_mutex);
+        if (dependency.m_pending.load(std::memory_order_relaxed) != 0) {
+            dependency.m_continuations.emplace_back(std::move(job), counter);
+            return;
+        }
+    }
+
+    submit({std::move(job), counter});
+}
+
+void JobSystem::runOnMainThread(Job job, Counter *counter) {
+    if (counter) {
+        counter->m_pending.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    std::scoped_lock lock(m_mainThreadMutex);
+    m_mainThreadJobs.push_back({std::move(job), counter});
+}
+
+void JobSystem::wait(const Counter &counter) {
+    const std::optional<uint32_t> self =
+        t_jobSystem == this ? std::optional(t_workerIndex) : std::nullopt;
+    const bool mainThread = isMainThread();
+
+    while (!counter.isDone()) {
+        if (mainThread && tryRunMainThreadJob()) {
+            continue;
+        }
+
+        if (!tryRunJob(self)) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void JobSystem::processMainThreadJobs() {
+    while (tryRunMainThreadJob()) {
+    }
+}
+
+uint32_t JobSystem::workerCount() const {
+    return static_cast<uint32_t>(m_workers.size());
+}
+
+bool JobSystem::isMainThread() const {
+    return std::this_thread::get_id() == m_mainThread;
+}
+
+void JobSystem::submit(QueuedJob job) {
+    if (t_jobSystem == this) {
+        Worker &worker = *m_workers[t_workerIndex];
+        std::scoped_lock lock(worker.mutex);
+        worker.jobs.push_back(std::move(job));
+    } else {
+        std::scoped_lock lock(m_sharedMutex);
+        m_sharedJobs.push_back(std::move(job));
+    }
+
+    m_queuedJobs.fetch_add(1, std::memory_order_release);
+    {
+        // Pairs with the predicate check in workerLoop() so a worker about to
+        // sleep cannot miss this job.
+        std::scoped_lock lock(m_sleepMutex);
+    }
+    m_wakeCondition.notify_one();
+}
+
+void JobSystem::execute(QueuedJob &job) {
+    job.job();
+    finish(job.counter);
+}
+
+void JobSystem::finish(Counter *counter) {
+    if (!counter) {
+        return;
+    }
+
+    std::vector<std::pair<Job, Counter *>> continuations;
+    {
+        std::scoped_lock lock(counter->m_mutex);
+        if (counter->m_pending.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+            return;
+        }
+
+        continuations.swap(counter->m_continuations);
+    }
+
+    for (auto &[job, jobCounter] : continuations) {
+        submit({std::move(job), jobCounter});
+    }
+}
+
+bool JobSystem::tryRunJob(const std::optional<uint32_t> self) {
+    std::optional<QueuedJob> job;
+
+    // Newest local work first, it is the most likely to still be in cache.
+    if (self) {
+        Worker &worker = *m_workers[*self];
+        std::scoped_lock lock(worker.mutex);
+        if (!worker.jobs.empty()) {
+            job = std::move(worker.jobs.back());
+            worker.jobs.pop_back();
+        }
+    }
+
+    if (!job) {
+        std::scoped_lock lock(m_sharedMutex);
+        if (!m_sharedJobs.empty()) {
+            job = std::move(m_sharedJobs.front());
+            m_sharedJobs.pop_front();
+        }
+    }
+
+    // Steal the oldest job of another worker, starting with our neighbour so
+    // thieves spread out instead of all hitting worker 0.
+    const auto workerCount = static_cast<uint32_t>(m_workers.size());
+    const uint32_t start = self ? *self + 1 : 0;
+    for (uint32_t offset = 0; !job && offset < workerCount; offset++) {
+        const uint32_t victim = (start + offset) % workerCount;
+        if (self && victim == *self) {
+            continue;
+        }
+
+        Worker &worker = *m_workers[victim];
+        std::scoped_lock lock(worker.mutex);
+        if (!worker.jobs.empty()) {
+            job = std::move(worker.jobs.front());
+            worker.jobs.pop_front();
+        }
+    }
+
+    if (!job) {
+        return false;
+    }
+
+    m_queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+    execute(*job);
+    return true;
+}
+
+bool JobSystem::tryRunMainThreadJob() {
+    QueuedJob job;
+    {
+        std::scoped_lock lock(m_mainThreadMutex);
+        if (m_mainThreadJobs.empty()) {
+            return false;
+        }
+
+        job = std::move(m_mainThreadJobs.front());
+        m_mainThreadJobs.pop_front();
+    }
+
+    execute(job);
+    return true;
+}
+
+void JobSystem::workerLoop(const std::stop_token &stopToken,
+                           const uint32_t index) {
+    t_jobSystem = this;
+    t_workerIndex = index;
+
+    while (!stopToken.stop_requested()) {
+        if (tryRunJob(index)) {
+            continue;
+        }
+
+        std::unique_lock lock(m_sleepMutex);
+        m_wakeCondition.wait(lock, stopToken, [this] {
+            return m_queuedJobs.load(std::memory_order_acquire) != 0;
+        });
+    }
+}
+
+}  // namespace avenir::jobs
@@ -0,0 +1,445 @@
+#include "avenir/scene/Archetype.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+
+namespace avenir::scene {
+
+namespace {
+
+std::size_t alignUp(const std::size_t value, const std::size_t alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+// Returns the number of bytes a chunk needs to hold `capacity` rows, filling
+// `offsets` with the start of each component array. The header comes first,
+// then the entity slot indices, then one change tick array per component.
+std::size_t layoutChunk(const std::vector<const ComponentInfo *> &components,
+                        const uint32_t capacity,
+                        std::vector<std::size_t> &offsets) {
+    offsets.clear();
+
+    std::size_t offset = Archetype::kChunkHeaderSize +
+                         sizeof(uint32_t) * capacity * (1 + components.size());
+    for (const ComponentInfo *info : components) {
+        offset = alignUp(offset, info->alignment);
+        offsets.emplace_back(offset);
+        offset += info->size * capacity;
+    }
+
+    return offset;
+}
+
+}  // namespace
+
+Archetype::Archetype(std::vector<const ComponentInfo *> components,
+                     ChunkAllocator &allocator)
+    : m_components(std::move(components)), m_allocator(&allocator) {
+    m_columnByType.fill(kNoColumn);
+
+    std::size_t rowSize = sizeof(uint32_t);
+    for (std::size_t column = 0; column < m_components.size(); column++) {
+        const ComponentInfo &info = *m_components[column];
+        m_mask.set(info.id);
+        m_columnByType[info.id] = static_cast<uint8_t>(column);
+        rowSize += sizeof(uint32_t) + info.size;
+    }
+
+    // Start from the unpadded estimate and shrink until alignment padding
+    // fits. Components larger than a chunk get a chunk of their own.
+    m_chunkCapacity = std::max<uint32_t>(
+        1, static_cast<uint32_t>((kChunkSize - kChunkHeaderSize) / rowSize));
+    while (m_chunkCapacity > 1 &&
+           layoutChunk(m_components, m_chunkCapacity, m_columnOffsets) >
+               kChunkSize) {
+        m_chunkCapacity--;
+    }
+
+    m_chunkBytes = std::max(
+        kChunkSize, layoutChunk(m_components, m_chunkCapacity, m_columnOffsets));
+}
+
+Archetype::~Archetype() {
+    releaseRetiredChunks();
+
+    for (std::size_t chunk = 0; chunk < m_chunks.size(); chunk++) {
+        // The spare chunk past the last row is empty.
+        releaseChunk(m_chunks[chunk],
+                     chunk < chunkCount() ? chunkSize(chunk) : 0);
+    }
+}
+
+const std::vector<const ComponentInfo *> &Archetype::components() const {
+    return m_components;
+}
+
+const ComponentMask &Archetype::mask() const { return m_mask; }
+
+bool Archetype::contains(const ComponentInfo &info) const {
+    return m_mask.test(info.id);
+}
+
+std::optional<std::size_t> Archetype::columnIndex(
+    const ComponentInfo &info) const {
+    if (!m_mask.test(info.id)) {
+        return std::nullopt;
+    }
+
+    return m_columnByType[info.id];
+}
+
+uint32_t Archetype::size() const { return m_size; }
+
+uint32_t Archetype::chunkCapacity() const { return m_chunkCapacity; }
+
+std::size_t Archetype::chunkCount() const {
+    // Excludes the spare chunk kept around by eraseRow().
+    return (m_size + m_chunkCapacity - 1) / m_chunkCapacity;
+}
+
+uint32_t Archetype::chunkSize(const std::size_t chunk) const {
+    const uint32_t first = static_cast<uint32_t>(chunk) * m_chunkCapacity;
+
+    return std::min(m_chunkCapacity, m_size - first);
+}
+
+uint32_t Archetype::pushRow(const uint32_t entity, const uint32_t tick) {
+    const uint32_t row = m_size;
+    if (row / m_chunkCapacity >= m_chunks.size()) {
+        m_chunks.emplace_back(allocateChunk());
+        m_chunkShared.emplace_back(0);
+        m_chunkTicks.resize(m_chunks.size() * m_components.size(), 0);
+    }
+
+    // Unshared before the row count changes, so a copy takes only the rows
+    // the snapshot can see.
+    std::byte *chunk = writableChunk(row / m_chunkCapacity);
+    m_size++;
+
+    *entityAddress(chunk, row) = entity;
+
+    for (std::size_t column = 0; column < m_components.size(); column++) {
+        setChangeTick(column, row, tick);
+    }
+
+    return row;
+}
+
+uint32_t Archetype::pushRows(const std::span<const uint32_t> entities,
+                             const uint32_t tick) {
+    const uint32_t first = m_size;
+    const std::size_t chunksNeeded =
+        (m_size + entities.size() + m_chunkCapacity - 1) / m_chunkCapacity;
+    m_chunks.reserve(chunksNeeded);
+    m_chunkShared.reserve(chunksNeeded);
+
+    for (const uint32_t entity : entities) {
+        pushRow(entity, tick);
+    }
+
+    return first;
+}
+
+void Archetype::fillColumn(const std::size_t column, const uint32_t firstRow,
+                           const uint32_t count, const void *source) {
+    const ComponentInfo &info = *m_components[column];
+
+    uint32_t row = firstRow;
+    const uint32_t end = firstRow + count;
+    while (row < end) {
+        const uint32_t chunkEnd =
+            std::min(end, (row / m_chunkCapacity + 1) * m_chunkCapacity);
+        info.copyFill(rowAddress(writableChunk(row / m_chunkCapacity), column,
+                                 row),
+                      source, chunkEnd - row);
+        row = chunkEnd;
+    }
+}
+
+void Archetype::moveRowTo(const uint32_t row, Archetype &destination,
+                          const uint32_t destinationRow) {
+    std::byte *chunk = writableChunk(row / m_chunkCapacity);
+    std::byte *destinationChunk =
+        destination.writableChunk(destinationRow / destination.m_chunkCapacity);
+
+    for (std::size_t column = 0; column < m_components.size(); column++) {
+        const ComponentInfo &info = *m_components[column];
+        void *source = rowAddress(chunk, column, row);
+
+        if (const auto destinationColumn = destination.columnIndex(info)) {
+            info.moveConstruct(
+                destination.rowAddress(destinationChunk, *destinationColumn,
+                                       destinationRow),
+                source);
+            destination.setChangeTick(*destinationColumn, destinationRow,
+                                      changeTick(column, row));
+        }
+
+        info.destroy(source);
+    }
+}
+
+void Archetype::destroyRow(const uint32_t row) {
+    std::byte *chunk = writableChunk(row / m_chunkCapacity);
+    for (std::size_t column = 0; column < m_components.size(); column++) {
+        m_components[column]->destroy(rowAddress(chunk, column, row));
+    }
+}
+
+std::optional<uint32_t> Archetype::eraseRow(const uint32_t row) {
+    const uint32_t last = m_size - 1;
+    std::optional<uint32_t> relocated;
+
+    if (row != last) {
+        std::byte *chunk = writableChunk(row / m_chunkCapacity);
+        std::byte *lastChunk = writableChunk(last / m_chunkCapacity);
+
+        for (std::size_t column = 0; column < m_components.size(); column++) {
+            const ComponentInfo &info = *m_components[column];
+            info.moveConstruct(rowAddress(chunk, column, row),
+                               rowAddress(lastChunk, column, last));
+            info.destroy(rowAddress(lastChunk, column, last));
+            setChangeTick(column, row, changeTick(column, last));
+        }
+
+        relocated = entityAt(last);
+        *entityAddress(chunk, row) = *relocated;
+    }
+
+    m_size--;
+
+    // Keep one empty chunk spare so entities churning across a chunk
+    // boundary do not allocate and free a chunk on every operation. Empty
+    // chunks are never shared.
+    if (m_chunks.size() >= 2 &&
+        (m_chunks.size() - 2) * m_chunkCapacity >= m_size) {
+        m_allocator->deallocate(m_chunks.back(), m_chunkBytes);
+        m_chunks.pop_back();
+        m_chunkShared.pop_back();
+        m_chunkTicks.resize(m_chunks.size() * m_components.size());
+    }
+
+    return relocated;
+}
+
+void *Archetype::componentAt(const std::size_t column, const uint32_t row) {
+    return rowAddress(writableChunk(row / m_chunkCapacity), column, row);
+}
+
+const void *Archetype::componentAt(const std::size_t column,
+                                   const uint32_t row) const {
+    return rowAddress(chunkData(row / m_chunkCapacity), column, row);
+}
+
+uint32_t Archetype::entityAt(const uint32_t row) const {
+    return *entityAddress(chunkData(row / m_chunkCapacity), row);
+}
+
+std::span<const uint32_t> Archetype::entities(const std::size_t chunk) const {
+    return sharedEntities(chunkData(chunk), chunkSize(chunk));
+}
+
+uint32_t Archetype::changeTick(const std::size_t column,
+                               const uint32_t row) const {
+    return *tickAddress(chunkData(row / m_chunkCapacity), column, row);
+}
+
+void Archetype::setChangeTick(const std::size_t column, const uint32_t row,
+                              const uint32_t tick) {
+    *tickAddress(writableChunk(row / m_chunkCapacity), column, row) = tick;
+
+    // Rows of one chunk may be stamped from several jobs at once; they all
+    // write the same tick, but the shared chunk tick still needs to be atomic.
+    std::atomic_ref chunkTick(
+        m_chunkTicks[row / m_chunkCapacity * m_components.size() + column]);
+    if (chunkTick.load(std::memory_order_relaxed) < tick) {
+        chunkTick.store(tick, std::memory_order_relaxed);
+    }
+}
+
+uint32_t Archetype::chunkChangeTick(const std::size_t chunk,
+                                    const std::size_t column) const {
+    return m_chunkTicks[chunk * m_components.size() + column];
+}
+
+std::span<const uint32_t> Archetype::changeTicks(
+    const std::size_t chunk, const std::size_t column) const {
+    return {tickAddress(chunkData(chunk), column,
+                        static_cast<uint32_t>(chunk) * m_chunkCapacity),
+            chunkSize(chunk)};
+}
+
+void Archetype::markChunkChanged(const std::size_t chunk,
+                                 const std::size_t column,
+                                 const uint32_t tick) {
+    std::fill_n(tickAddress(writableChunk(chunk), column,
+                            static_cast<uint32_t>(chunk) * m_chunkCapacity),
+                chunkSize(chunk), tick);
+    m_chunkTicks[chunk * m_components.size() + column] = tick;
+}
+
+bool Archetype::isShareable() const {
+    return std::ranges::all_of(m_components, [](const ComponentInfo *info) {
+        return info->copyConstruct != nullptr;
+    });
+}
+
+std::byte *Archetype::shareChunk(const std::size_t chunk) {
+    std::byte *data = m_chunks[chunk];
+    reinterpret_cast<ChunkHeader *>(data)->references.fetch_add(
+        1, std::memory_order_relaxed);
+    m_chunkShared[chunk] = 1;
+
+    return data;
+}
+
+void Archetype::releaseChunk(std::byte *chunk, const uint32_t rows) const {
+    auto *header = reinterpret_cast<ChunkHeader *>(chunk);
+    if (header->references.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+        return;
+    }
+
+    destroyRows(chunk, rows);
+    std::destroy_at(header);
+    m_allocator->deallocate(chunk, m_chunkBytes);
+}
+
+void Archetype::releaseRetiredChunks() {
+    for (const auto &[chunk, rows] : m_retiredChunks) {
+        releaseChunk(chunk, rows);
+    }
+
+    m_retiredChunks.clear();
+}
+
+std::span<const uint32_t> Archetype::sharedEntities(const std::byte *chunk,
+                                                    const uint32_t rows) const {
+    return {reinterpret_cast<const uint32_t *>(chunk + kChunkHeaderSize),
+            rows};
+}
+
+const void *Archetype::sharedColumn(const std::byte *chunk,
+                                    const std::size_t column) const {
+    return chunk + m_columnOffsets[column];
+}
+
+Archetype *Archetype::addEdge(const ComponentInfo &info) const {
+    return m_addEdges[info.id];
+}
+
+Archetype *Archetype::removeEdge(const ComponentInfo &info) const {
+    return m_removeEdges[info.id];
+}
+
+void Archetype::setAddEdge(const ComponentInfo &info, Archetype *archetype) {
+    m_addEdges[info.id] = archetype;
+}
+
+void Archetype::setRemoveEdge(const ComponentInfo &info, Archetype *archetype) {
+    m_removeEdges[info.id] = archetype;
+}
+
+std::byte *Archetype::allocateChunk() const {
+    std::byte *chunk = m_allocator->allocate(m_chunkBytes);
+    std::construct_at(reinterpret_cast<ChunkHeader *>(chunk), 1u);
+
+    return chunk;
+}
+
+std::byte *Archetype::chunkData(const std::size_t chunk) const {
+    return std::atomic_ref(const_cast<std::byte *&>(m_chunks[chunk]))
+        .load(std::memory_order_acquire);
+}
+
+std::byte *Archetype::writableChunk(const std::size_t chunk) {
+    std::atomic_ref shared(m_chunkShared[chunk]);
+    if (shared.load(std::memory_order_acquire) == 0) {
+        return chunkData(chunk);
+    }
+
+    // Several systems may write different columns of the same chunk at once;
+    // the first one copies it and the rest pick up the copy.
+    std::lock_guard lock(m_copyMutex);
+    if (shared.load(std::memory_order_relaxed) != 0) {
+        const uint32_t rows = chunkSize(chunk);
+        std::byte *copy = copyChunk(m_chunks[chunk], rows);
+
+        // Readers that already hold the old pointer keep using it until
+        // releaseRetiredChunks().
+        m_retiredChunks.push_back({m_chunks[chunk], rows});
+        std::atomic_ref(m_chunks[chunk]).store(copy, std::memory_order_release);
+        shared.store(0, std::memory_order_release);
+    }
+
+    return m_chunks[chunk];
+}
+
+std::byte *Archetype::copyChunk(const std::byte *source,
+                                const uint32_t rows) const {
+    std::byte *copy = allocateChunk();
+
+    // Entity indices and change ticks.
+    std::memcpy(copy + kChunkHeaderSize, source + kChunkHeaderSize,
+                sizeof(uint32_t) * m_chunkCapacity * (1 + m_components.size()));
+
+    std::size_t column = 0;
+    uint32_t row = 0;
+    try {
+        for (; column < m_components.size(); column++) {
+            const ComponentInfo &info = *m_components[column];
+            if (info.triviallyCopyable) {
+                std::memcpy(copy + m_columnOffsets[column],
+                            source + m_columnOffsets[column], info.size * rows);
+                continue;
+            }
+
+            for (row = 0; row < rows; row++) {
+                info.copyConstruct(
+                    copy + m_columnOffsets[column] + info.size * row,
+                    source + m_columnOffsets[column] + info.size * row);
+            }
+        }
+    } catch (...) {
+        // Unwind the columns copied so far and the partial one.
+        for (std::size_t copied = 0; copied <= column; copied++) {
+            const ComponentInfo &info = *m_components[copied];
+            const uint32_t copiedRows = copied < column ? rows : row;
+            for (uint32_t i = 0; i < copiedRows; i++) {
+                info.destroy(copy + m_columnOffsets[copied] + info.size * i);
+            }
+        }
+
+        m_allocator->deallocate(copy, m_chunkBytes);
+        throw;
+    }
+
+    return copy;
+}
+
+void Archetype::destroyRows(std::byte *chunk, const uint32_t rows) const {
+    for (std::size_t column = 0; column < m_components.size(); column++) {
+        for (uint32_t row = 0; row < rows; row++) {
+            m_components[column]->destroy(rowAddress(chunk, column, row));
+        }
+    }
+}
+
+std::byte *Archetype::rowAddress(std::byte *chunk, const std::size_t column,
+                                 const uint32_t row) const {
+    return chunk + m_columnOffsets[column] +
+           m_components[column]->size * (row % m_chunkCapacity);
+}
+
+uint32_t *Archetype::entityAddress(std::byte *chunk, const uint32_t row) const {
+    return reinterpret_cast<uint32_t *>(chunk + kChunkHeaderSize) +
+           row % m_chunkCapacity;
+}
+
+uint32_t *Archetype::tickAddress(std::byte *chunk, const std::size_t column,
+                                 const uint32_t row) const {
+    return reinterpret_cast<uint32_t *>(chunk + kChunkHeaderSize) +
+           m_chunkCapacity * (1 + column) + row % m_chunkCapacity;
+}
+
+}  // namespace avenir::scene
@@ -0,0 +1,97 @@
+#include "avenir/scene/Bounds.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include <glm/glm.hpp>
+
+namespace avenir::scene {
+
+Aabb Aabb::transformed(const glm::mat4 &matrix) const {
+    // Transform the center, then project the extents onto each world axis
+    // through the absolute rotation-scale part of the matrix.
+    const glm::vec3 localCenter = center();
+    const glm::vec3 localExtents = extents();
+
+    glm::vec3 worldCenter(matrix[3]);
+    glm::vec3 worldExtents(0.0f);
+    for (int column = 0; column < 3; column++) {
+        for (int row = 0; row < 3; row++) {
+            worldCenter[row] += matrix[column][row] * localCenter[column];
+            worldExtents[row] +=
+                std::abs(matrix[column][row]) * localExtents[column];
+        }
+    }
+
+    return {worldCenter - worldExtents, worldCenter + worldExtents};
+}
+
+std::optional<float> Ray::intersect(const Aabb &box,
+                                    const float maxDistance) const {
+    float entry = 0.0f;
+    float exit = maxDistance;
+
+    for (int axis = 0; axis < 3; axis++) {
+        const float inverse = 1.0f / direction[axis];
+        float near = (box.min[axis] - origin[axis]) * inverse;
+        float far = (box.max[axis] - origin[axis]) * inverse;
+        if (near > far) {
+            std::swap(near, far);
+        }
+
+        entry = std::max(entry, near);
+        exit = std::min(exit, far);
+        if (entry > exit) {
+            return std::nullopt;
+        }
+    }
+
+    return entry;
+}
+
+Frustum Frustum::fromMatrix(const glm::mat4 &viewProjection) {
+    // Gribb-Hartmann: each plane is the last row of the matrix plus or minus
+    // one of the others.
+    const auto row = [&](const int index) {
+        return glm::vec4(viewProjection[0][index], viewProjection[1][index],
+                         viewProjection[2][index], viewProjection[3][index]);
+    };
+
+    Frustum frustum;
+    frustum.planes = {row(3) + row(0), row(3) - row(0), row(3) + row(1),
+                      row(3) - row(1), row(3) + row(2), row(3) - row(2)};
+
+    for (glm::vec4 &plane : frustum.planes) {
+        plane = plane / glm::length(glm::vec3(plane));
+    }
+
+    return frustum;
+}
+
+bool Frustum::intersects(const Aabb &box) const {
+    return classify(box) != Containment::eOutside;
+}
+
+Frustum::Containment Frustum::classify(const Aabb &box) const {
+    const glm::vec3 center = box.center();
+    const glm::vec3 extents = box.extents();
+
+    Containment result = Containment::eInside;
+    for (const glm::vec4 &plane : planes) {
+        const glm::vec3 normal(plane);
+        const float distance = glm::dot(normal, center) + plane.w;
+        const float radius = glm::dot(glm::abs(normal), extents);
+
+        if (distance < -radius) {
+            return Containment::eOutside;
+        }
+
+        if (distance < radius) {
+            result = Containment::eIntersecting;
+        }
+    }
+
+    return result;
+}
+
+}  // namespace avenir::scene
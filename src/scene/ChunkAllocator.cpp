@@ -0,0 +1,64 @@
+#include "avenir/scene/ChunkAllocator.hpp"
+
+#include <new>
+
+namespace avenir::scene {
+
+ChunkAllocator::~ChunkAllocator() { releaseFreeBlocks(); }
+
+std::byte *ChunkAllocator::allocate(const std::size_t size) {
+    std::lock_guard lock(m_mutex);
+    m_stats.blocksInUse++;
+
+    if (size == kBlockSize && m_freeList) {
+        FreeBlock *block = m_freeList;
+        m_freeList = block->next;
+        m_stats.blocksFree--;
+        m_stats.pooledAllocations++;
+
+        return reinterpret_cast<std::byte *>(block);
+    }
+
+    m_stats.heapAllocations++;
+
+    return allocateFromHeap(size);
+}
+
+void ChunkAllocator::deallocate(std::byte *block, const std::size_t size) {
+    std::lock_guard lock(m_mutex);
+    m_stats.blocksInUse--;
+
+    if (size != kBlockSize) {
+        m_stats.heapDeallocations++;
+        deallocateToHeap(block, size);
+        return;
+    }
+
+    m_freeList = new (block) FreeBlock{m_freeList};
+    m_stats.blocksFree++;
+}
+
+void ChunkAllocator::releaseFreeBlocks() {
+    std::lock_guard lock(m_mutex);
+    while (m_freeList) {
+        FreeBlock *block = m_freeList;
+        m_freeList = block->next;
+
+        deallocateToHeap(reinterpret_cast<std::byte *>(block), kBlockSize);
+        m_stats.heapDeallocations++;
+        m_stats.blocksFree--;
+    }
+}
+
+const AllocationStats &ChunkAllocator::stats() const { return m_stats; }
+
+std::byte *ChunkAllocator::allocateFromHeap(const std::size_t size) {
+    return static_cast<std::byte *>(
+        ::operator new[](size, std::align_val_t{kBlockAlignment}));
+}
+
+void ChunkAllocator::deallocateToHeap(std::byte *block, const std::size_t size) {
+    ::operator delete[](block, size, std::align_val_t{kBlockAlignment});
+}
+
+}  // namespace avenir::scene
@@ -0,0 +1,40 @@
+#include "avenir/scene/ComponentRegistry.hpp"
+
+#include <array>
+#include <atomic>
+
+namespace avenir::scene {
+
+namespace {
+
+// Constant-initialised, so registration from other static initialisers is
+// safe regardless of translation unit order.
+constinit std::array<std::atomic<const ComponentInfo *>, kMaxComponentTypes>
+    componentTable{};
+
+}  // namespace
+
+void registerComponentInfo(const ComponentInfo &info) {
+    componentTable[info.id].store(&info, std::memory_order_release);
+}
+
+const ComponentInfo *ComponentRegistry::find(const ComponentTypeId id) {
+    if (id >= kMaxComponentTypes) {
+        return nullptr;
+    }
+
+    return componentTable[id].load(std::memory_order_acquire);
+}
+
+const ComponentInfo *ComponentRegistry::find(const std::string_view name) {
+    for (const auto &slot : componentTable) {
+        const ComponentInfo *info = slot.load(std::memory_order_acquire);
+        if (info && info->name == name) {
+            return info;
+        }
+    }
+
+    return nullptr;
+}
+
+}  // namespace avenir::scene
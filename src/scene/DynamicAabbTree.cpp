@@ -0,0 +1,301 @@
+#include "avenir/scene/DynamicAabbTree.hpp"
+
+#include <algorithm>
+
+namespace avenir::scene {
+
+DynamicAabbTree::DynamicAabbTree(const float margin) : m_margin(margin) {}
+
+uint32_t DynamicAabbTree::createProxy(const Aabb &bounds,
+                                      const uint32_t userData) {
+    const uint32_t proxy = allocateNode();
+    Node &node = m_nodes[proxy];
+    node.bounds = bounds.expanded(m_margin);
+    m_leafBounds[proxy] = bounds;
+    node.userData = userData;
+
+    insertLeaf(proxy);
+    m_proxyCount++;
+
+    return proxy;
+}
+
+void DynamicAabbTree::destroyProxy(const uint32_t proxy) {
+    removeLeaf(proxy);
+    freeNode(proxy);
+    m_proxyCount--;
+}
+
+bool DynamicAabbTree::moveProxy(const uint32_t proxy, const Aabb &bounds) {
+    m_leafBounds[proxy] = bounds;
+    if (m_nodes[proxy].bounds.contains(bounds)) {
+        return false;
+    }
+
+    removeLeaf(proxy);
+    m_nodes[proxy].bounds = bounds.expanded(m_margin);
+    insertLeaf(proxy);
+
+    return true;
+}
+
+uint32_t DynamicAabbTree::userData(const uint32_t proxy) const {
+    return m_nodes[proxy].userData;
+}
+
+const Aabb &DynamicAabbTree::bounds(const uint32_t proxy) const {
+    return m_leafBounds[proxy];
+}
+
+const Aabb &DynamicAabbTree::fatBounds(const uint32_t proxy) const {
+    return m_nodes[proxy].bounds;
+}
+
+uint32_t DynamicAabbTree::proxyCount() const { return m_proxyCount; }
+
+uint32_t DynamicAabbTree::height() const {
+    return m_root == kNullNode ? 0 : m_nodes[m_root].height + 1;
+}
+
+float DynamicAabbTree::areaRatio() const {
+    if (m_root == kNullNode) {
+        return 0.0f;
+    }
+
+    float totalArea = 0.0f;
+    m_stack.clear();
+    m_stack.emplace_back(m_root);
+    while (!m_stack.empty()) {
+        const Node &node = m_nodes[m_stack.back()];
+        m_stack.pop_back();
+
+        if (!node.isLeaf()) {
+            totalArea += node.bounds.surfaceArea();
+            m_stack.emplace_back(node.child1);
+            m_stack.emplace_back(node.child2);
+        }
+    }
+
+    const float rootArea = m_nodes[m_root].bounds.surfaceArea();
+
+    return rootArea > 0.0f ? totalArea / rootArea : 0.0f;
+}
+
+uint32_t DynamicAabbTree::allocateNode() {
+    if (m_freeList == kNullNode) {
+        m_nodes.emplace_back();
+        m_leafBounds.emplace_back();
+        return static_cast<uint32_t>(m_nodes.size() - 1);
+    }
+
+    const uint32_t node = m_freeList;
+    m_freeList = m_nodes[node].parent;
+    m_nodes[node] = Node{};
+
+    return node;
+}
+
+void DynamicAabbTree::freeNode(const uint32_t node) {
+    m_nodes[node].parent = m_freeList;
+    m_nodes[node].child1 = kNullNode;
+    m_nodes[node].child2 = kNullNode;
+    m_freeList = node;
+}
+
+void DynamicAabbTree::insertLeaf(const uint32_t leaf) {
+    if (m_root == kNullNode) {
+        m_root = leaf;
+        m_nodes[leaf].parent = kNullNode;
+        return;
+    }
+
+    const uint32_t sibling = findBestSibling(m_nodes[leaf].bounds);
+    const uint32_t oldParent = m_nodes[sibling].parent;
+
+    // May grow m_nodes, so no references are held across it.
+    const uint32_t newParent = allocateNode();
+    Node &parent = m_nodes[newParent];
+    parent.parent = oldParent;
+    parent.bounds = m_nodes[sibling].bounds.merged(m_nodes[leaf].bounds);
+    parent.child1 = sibling;
+    parent.child2 = leaf;
+    parent.height = m_nodes[sibling].height + 1;
+
+    if (oldParent == kNullNode) {
+        m_root = newParent;
+    } else if (m_nodes[oldParent].child1 == sibling) {
+        m_nodes[oldParent].child1 = newParent;
+    } else {
+        m_nodes[oldParent].child2 = newParent;
+    }
+
+    m_nodes[sibling].parent = newParent;
+    m_nodes[leaf].parent = newParent;
+
+    refitAncestors(newParent);
+}
+
+void DynamicAabbTree::removeLeaf(const uint32_t leaf) {
+    if (leaf == m_root) {
+        m_root = kNullNode;
+        return;
+    }
+
+    const uint32_t parent = m_nodes[leaf].parent;
+    const uint32_t grandParent = m_nodes[parent].parent;
+    const uint32_t sibling = m_nodes[parent].child1 == leaf
+                                 ? m_nodes[parent].child2
+                                 : m_nodes[parent].child1;
+
+    // The sibling takes the parent's place.
+    m_nodes[sibling].parent = grandParent;
+    m_nodes[leaf].parent = kNullNode;
+    freeNode(parent);
+
+    if (grandParent == kNullNode) {
+        m_root = sibling;
+        return;
+    }
+
+    if (m_nodes[grandParent].child1 == parent) {
+        m_nodes[grandParent].child1 = sibling;
+    } else {
+        m_nodes[grandParent].child2 = sibling;
+    }
+
+    refitAncestors(grandParent);
+}
+
+uint32_t DynamicAabbTree::findBestSibling(const Aabb &bounds) const {
+    // Pairing the new leaf with sibling S costs the area of their new parent
+    // plus the area every ancestor of S grows by. Descending can only add to
+    // the inherited growth, and no parent can be smaller than the leaf
+    // itself, so leafArea + inherited cost bounds a whole subtree from below.
+    // Subtrees are expanded cheapest bound first, and the search stops once
+    // no bound can beat the best sibling found.
+    const float leafArea = bounds.surfaceArea();
+    const auto greaterCost = [](const std::pair<uint32_t, float> &lhs,
+                                const std::pair<uint32_t, float> &rhs) {
+        return lhs.second > rhs.second;
+    };
+
+    uint32_t bestSibling = m_root;
+    float bestCost = m_nodes[m_root].bounds.merged(bounds).surfaceArea();
+
+    m_costStack.clear();
+    m_costStack.emplace_back(m_root, 0.0f);
+    while (!m_costStack.empty()) {
+        std::ranges::pop_heap(m_costStack, greaterCost);
+        const auto [index, inheritedCost] = m_costStack.back();
+        m_costStack.pop_back();
+
+        if (leafArea + inheritedCost >= bestCost) {
+            break;
+        }
+
+        const Node &node = m_nodes[index];
+        const float directCost = node.bounds.merged(bounds).surfaceArea();
+        const float cost = directCost + inheritedCost;
+        if (cost < bestCost) {
+            bestSibling = index;
+            bestCost = cost;
+        }
+
+        if (node.isLeaf()) {
+            continue;
+        }
+
+        const float childInheritedCost =
+            inheritedCost + directCost - node.bounds.surfaceArea();
+        if (leafArea + childInheritedCost < bestCost) {
+            m_costStack.emplace_back(node.child1, childInheritedCost);
+            std::ranges::push_heap(m_costStack, greaterCost);
+            m_costStack.emplace_back(node.child2, childInheritedCost);
+            std::ranges::push_heap(m_costStack, greaterCost);
+        }
+    }
+
+    return bestSibling;
+}
+
+void DynamicAabbTree::refitAncestors(uint32_t node) {
+    while (node != kNullNode) {
+        Node &current = m_nodes[node];
+        const Node &child1 = m_nodes[current.child1];
+        const Node &child2 = m_nodes[current.child2];
+        current.bounds = child1.bounds.merged(child2.bounds);
+
+        // A rotation only rearranges the node's grandchildren, so its own
+        // bounds stay valid.
+        rotate(node);
+
+        current.height = 1 + std::max(m_nodes[current.child1].height,
+                                      m_nodes[current.child2].height);
+        node = current.parent;
+    }
+}
+
+void DynamicAabbTree::rotate(const uint32_t node) {
+    // Consider swapping either child of `node` with either grandchild under
+    // the other child, and take the swap that shrinks that other child the
+    // most. Only the other child's bounds change.
+    const Node &current = m_nodes[node];
+
+    uint32_t bestChild = kNullNode;
+    uint32_t bestGrandChild = kNullNode;
+    float bestReduction = 0.0f;
+
+    for (const auto &[child, other] :
+         {std::pair(current.child1, current.child2),
+          std::pair(current.child2, current.child1)}) {
+        const Node &otherNode = m_nodes[other];
+        if (otherNode.isLeaf()) {
+            continue;
+        }
+
+        const float otherArea = otherNode.bounds.surfaceArea();
+        for (const auto &[grandChild, remaining] :
+             {std::pair(otherNode.child1, otherNode.child2),
+              std::pair(otherNode.child2, otherNode.child1)}) {
+            const float reduction =
+                otherArea - m_nodes[child]
+                                .bounds.merged(m_nodes[remaining].bounds)
+                                .surfaceArea();
+            if (reduction > bestReduction) {
+                bestChild = child;
+                bestGrandChild = grandChild;
+                bestReduction = reduction;
+            }
+        }
+    }
+
+    if (bestChild == kNullNode) {
+        return;
+    }
+
+    const uint32_t other =
+        current.child1 == bestChild ? current.child2 : current.child1;
+    Node &otherNode = m_nodes[other];
+
+    if (m_nodes[node].child1 == bestChild) {
+        m_nodes[node].child1 = bestGrandChild;
+    } else {
+        m_nodes[node].child2 = bestGrandChild;
+    }
+
+    if (otherNode.child1 == bestGrandChild) {
+        otherNode.child1 = bestChild;
+    } else {
+        otherNode.child2 = bestChild;
+    }
+
+    m_nodes[bestGrandChild].parent = node;
+    m_nodes[bestChild].parent = other;
+
+    otherNode.bounds = m_nodes[otherNode.child1].bounds.merged(
+        m_nodes[otherNode.child2].bounds);
+    otherNode.height = 1 + std::max(m_nodes[otherNode.child1].height,
+                                    m_nodes[otherNode.child2].height);
+}
+
+}  // namespace avenir::scene
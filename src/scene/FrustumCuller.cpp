@@ -0,0 +1,339 @@
+#include "avenir/scene/FrustumCuller.hpp"
+
+#include <bit>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+#include <glm/glm.hpp>
+
+#include "avenir/scene/Scene.hpp"
+#include "avenir/scene/components/Camera.hpp"
+#include "avenir/scene/components/MeshRenderer.hpp"
+#include "avenir/scene/components/WorldTransform.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+#define AVENIR_CULLING_SSE 1
+#include <immintrin.h>
+#endif
+
+#if defined(AVENIR_CULLING_SSE) && (defined(__GNUC__) || defined(__clang__))
+#define AVENIR_CULLING_AVX2 1
+#endif
+
+namespace avenir::scene {
+
+namespace {
+
+constexpr std::size_t kPlaneCount = 6;
+
+// Signed distance of a point to each plane, and the absolute normal used to
+// project box extents onto it.
+struct PlaneStreams {
+    float normalX[kPlaneCount];
+    float normalY[kPlaneCount];
+    float normalZ[kPlaneCount];
+    float distance[kPlaneCount];
+    float absNormalX[kPlaneCount];
+    float absNormalY[kPlaneCount];
+    float absNormalZ[kPlaneCount];
+};
+
+PlaneStreams planeStreams(const Frustum &frustum) {
+    PlaneStreams planes{};
+    for (std::size_t p = 0; p < kPlaneCount; p++) {
+        planes.normalX[p] = frustum.planes[p].x;
+        planes.normalY[p] = frustum.planes[p].y;
+        planes.normalZ[p] = frustum.planes[p].z;
+        planes.distance[p] = frustum.planes[p].w;
+        planes.absNormalX[p] = std::abs(frustum.planes[p].x);
+        planes.absNormalY[p] = std::abs(frustum.planes[p].y);
+        planes.absNormalZ[p] = std::abs(frustum.planes[p].z);
+    }
+
+    return planes;
+}
+
+bool isVisible(const PlaneStreams &planes, const CullingBoundsArrays &b,
+               const std::size_t i) {
+    for (std::size_t p = 0; p < kPlaneCount; p++) {
+        const float distance = planes.normalX[p] * b.centerX[i] +
+                               planes.normalY[p] * b.centerY[i] +
+                               planes.normalZ[p] * b.centerZ[i] +
+                               planes.distance[p];
+        if (distance < -b.radius[i]) {
+            return false;
+        }
+
+        const float extent = planes.absNormalX[p] * b.extentX[i] +
+                             planes.absNormalY[p] * b.extentY[i] +
+                             planes.absNormalZ[p] * b.extentZ[i];
+        if (distance < -extent) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Appends base + the index of every set bit of `mask`.
+std::size_t appendVisible(unsigned mask, const std::size_t base,
+                          uint32_t *visible, std::size_t count) {
+    while (mask != 0) {
+        visible[count++] = static_cast<uint32_t>(base + std::countr_zero(mask));
+        mask &= mask - 1;
+    }
+
+    return count;
+}
+
+#ifdef AVENIR_CULLING_SSE
+std::size_t cullBoundsSse(const PlaneStreams &planes,
+                          const CullingBoundsArrays &b, std::size_t &i,
+                          const std::size_t count, uint32_t *visible,
+                          std::size_t visibleCount) {
+    const __m128 zero = _mm_setzero_ps();
+
+    for (; i + 4 <= count; i += 4) {
+        const __m128 cx = _mm_loadu_ps(&b.centerX[i]);
+        const __m128 cy = _mm_loadu_ps(&b.centerY[i]);
+        const __m128 cz = _mm_loadu_ps(&b.centerZ[i]);
+        const __m128 radius = _mm_loadu_ps(&b.radius[i]);
+
+        // Sphere pass; the plane distances are kept for the box pass.
+        __m128 distances[kPlaneCount];
+        __m128 outside = zero;
+        for (std::size_t p = 0; p < kPlaneCount; p++) {
+            distances[p] = _mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(_mm_set1_ps(planes.normalX[p]), cx),
+                           _mm_mul_ps(_mm_set1_ps(planes.normalY[p]), cy)),
+                _mm_add_ps(_mm_mul_ps(_mm_set1_ps(planes.normalZ[p]), cz),
+                           _mm_set1_ps(planes.distance[p])));
+            outside = _mm_or_ps(
+                outside, _mm_cmplt_ps(_mm_add_ps(distances[p], radius), zero));
+        }
+
+        unsigned mask = ~static_cast<unsigned>(_mm_movemask_ps(outside)) & 0xFu;
+        if (mask == 0) {
+            continue;
+        }
+
+        const __m128 ex = _mm_loadu_ps(&b.extentX[i]);
+        const __m128 ey = _mm_loadu_ps(&b.extentY[i]);
+        const __m128 ez = _mm_loadu_ps(&b.extentZ[i]);
+        outside = zero;
+        for (std::size_t p = 0; p < kPlaneCount; p++) {
+            const __m128 extent = _mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(_mm_set1_ps(planes.absNormalX[p]), ex),
+                           _mm_mul_ps(_mm_set1_ps(planes.absNormalY[p]), ey)),
+                _mm_mul_ps(_mm_set1_ps(planes.absNormalZ[p]), ez));
+            outside = _mm_or_ps(
+                outside, _mm_cmplt_ps(_mm_add_ps(distances[p], extent), zero));
+        }
+
+        mask &= ~static_cast<unsigned>(_mm_movemask_ps(outside));
+        visibleCount = appendVisible(mask, i, visible, visibleCount);
+    }
+
+    return visibleCount;
+}
+#endif
+
+#ifdef AVENIR_CULLING_AVX2
+__attribute__((target("avx2"))) std::size_t cullBoundsAvx2(
+    const PlaneStreams &planes, const CullingBoundsArrays &b, std::size_t &i,
+    const std::size_t count, uint32_t *visible, std::size_t visibleCount) {
+    const __m256 zero = _mm256_setzero_ps();
+
+    // Broadcast once rather than per batch.
+    __m256 normalX[kPlaneCount], normalY[kPlaneCount], normalZ[kPlaneCount];
+    __m256 distance[kPlaneCount];
+    __m256 absNormalX[kPlaneCount], absNormalY[kPlaneCount];
+    __m256 absNormalZ[kPlaneCount];
+    for (std::size_t p = 0; p < kPlaneCount; p++) {
+        normalX[p] = _mm256_set1_ps(planes.normalX[p]);
+        normalY[p] = _mm256_set1_ps(planes.normalY[p]);
+        normalZ[p] = _mm256_set1_ps(planes.normalZ[p]);
+        distance[p] = _mm256_set1_ps(planes.distance[p]);
+        absNormalX[p] = _mm256_set1_ps(planes.absNormalX[p]);
+        absNormalY[p] = _mm256_set1_ps(planes.absNormalY[p]);
+        absNormalZ[p] = _mm256_set1_ps(planes.absNormalZ[p]);
+    }
+
+    for (; i + 8 <= count; i += 8) {
+        const __m256 cx = _mm256_loadu_ps(&b.centerX[i]);
+        const __m256 cy = _mm256_loadu_ps(&b.centerY[i]);
+        const __m256 cz = _mm256_loadu_ps(&b.centerZ[i]);
+        const __m256 radius = _mm256_loadu_ps(&b.radius[i]);
+
+        __m256 distances[kPlaneCount];
+        __m256 outside = zero;
+        for (std::size_t p = 0; p < kPlaneCount; p++) {
+            distances[p] = _mm256_add_ps(
+                _mm256_add_ps(_mm256_mul_ps(normalX[p], cx),
+                              _mm256_mul_ps(normalY[p], cy)),
+                _mm256_add_ps(_mm256_mul_ps(normalZ[p], cz), distance[p]));
+            outside = _mm256_or_ps(
+                outside, _mm256_cmp_ps(_mm256_add_ps(distances[p], radius),
+                                       zero, _CMP_LT_OQ));
+        }
+
+        unsigned mask =
+            ~static_cast<unsigned>(_mm256_movemask_ps(outside)) & 0xFFu;
+        if (mask == 0) {
+            continue;
+        }
+
+        const __m256 ex = _mm256_loadu_ps(&b.extentX[i]);
+        const __m256 ey = _mm256_loadu_ps(&b.extentY[i]);
+        const __m256 ez = _mm256_loadu_ps(&b.extentZ[i]);
+        outside = zero;
+        for (std::size_t p = 0; p < kPlaneCount; p++) {
+            const __m256 extent = _mm256_add_ps(
+                _mm256_add_ps(_mm256_mul_ps(absNormalX[p], ex),
+                              _mm256_mul_ps(absNormalY[p], ey)),
+                _mm256_mul_ps(absNormalZ[p], ez));
+            outside = _mm256_or_ps(
+                outside, _mm256_cmp_ps(_mm256_add_ps(distances[p], extent),
+                                       zero, _CMP_LT_OQ));
+        }
+
+        mask &= ~static_cast<unsigned>(_mm256_movemask_ps(outside));
+        visibleCount = appendVisible(mask, i, visible, visibleCount);
+    }
+
+    return visibleCount;
+}
+#endif
+
+}  // namespace
+
+void FrustumCuller::cull(Scene &scene, const EntityId camera,
+                         const float aspectRatio) {
+    gather(scene, camera, aspectRatio);
+
+    m_visible.resize(m_entities.size());
+    m_visibleCount = cullBounds(m_frustum, bounds(), m_visible);
+}
+
+void FrustumCuller::gather(Scene &scene, const EntityId camera,
+                           const float aspectRatio) {
+    const auto &cameraComponent = std::as_const(scene)
+                                      .component<components::Camera>(camera);
+
+    m_viewMatrix = scene.entityInverseWorldMatrix(camera);
+    m_projectionMatrix = cameraComponent.projectionMatrix(aspectRatio);
+    m_frustum = Frustum::fromMatrix(m_projectionMatrix * m_viewMatrix);
+
+    gatherEntities(scene);
+    m_visibleCount = 0;
+}
+
+const glm::mat4 &FrustumCuller::viewMatrix() const { return m_viewMatrix; }
+
+const glm::mat4 &FrustumCuller::projectionMatrix() const {
+    return m_projectionMatrix;
+}
+
+const Frustum &FrustumCuller::frustum() const { return m_frustum; }
+
+std::span<const EntityId> FrustumCuller::entities() const {
+    return m_entities;
+}
+
+std::span<const graphics::MeshHandle> FrustumCuller::meshes() const {
+    return m_meshes;
+}
+
+std::span<const glm::mat4> FrustumCuller::worldMatrices() const {
+    return m_worldMatrices;
+}
+
+CullingBoundsArrays FrustumCuller::bounds() const {
+    return {m_centerX, m_centerY, m_centerZ, m_radius,
+            m_extentX, m_extentY, m_extentZ};
+}
+
+std::span<const uint32_t> FrustumCuller::visibleIndices() const {
+    return {m_visible.data(), m_visibleCount};
+}
+
+std::size_t FrustumCuller::cullBounds(const Frustum &frustum,
+                                      const CullingBoundsArrays &bounds,
+                                      const std::span<uint32_t> visible) {
+    const std::size_t count = bounds.centerX.size();
+    for (const std::span<const float> stream :
+         {bounds.centerY, bounds.centerZ, bounds.radius, bounds.extentX,
+          bounds.extentY, bounds.extentZ}) {
+        if (stream.size() < count) {
+            throw std::runtime_error(
+                "Error: Culling bounds streams differ in length!\n");
+        }
+    }
+
+    if (visible.size() < count) {
+        throw std::runtime_error(
+            "Error: Visible index output is shorter than the bounds!\n");
+    }
+
+    const PlaneStreams planes = planeStreams(frustum);
+    std::size_t i = 0;
+    std::size_t visibleCount = 0;
+
+#ifdef AVENIR_CULLING_AVX2
+    static const bool hasAvx2 = __builtin_cpu_supports("avx2");
+    if (hasAvx2) {
+        visibleCount = cullBoundsAvx2(planes, bounds, i, count, visible.data(),
+                                      visibleCount);
+    }
+#endif
+
+#ifdef AVENIR_CULLING_SSE
+    visibleCount =
+        cullBoundsSse(planes, bounds, i, count, visible.data(), visibleCount);
+#endif
+
+    for (; i < count; i++) {
+        if (isVisible(planes, bounds, i)) {
+            visible[visibleCount++] = static_cast<uint32_t>(i);
+        }
+    }
+
+    return visibleCount;
+}
+
+void FrustumCuller::gatherEntities(Scene &scene) {
+    m_entities.clear();
+    m_meshes.clear();
+    m_worldMatrices.clear();
+    m_centerX.clear();
+    m_centerY.clear();
+    m_centerZ.clear();
+    m_radius.clear();
+    m_extentX.clear();
+    m_extentY.clear();
+    m_extentZ.clear();
+
+    scene.each<const components::WorldTransform,
+               const components::MeshRenderer>(
+        [this](const Entity entity, const components::WorldTransform &world,
+               const components::MeshRenderer &meshRenderer) {
+            const Aabb bounds =
+                meshRenderer.localBounds.transformed(world.matrix);
+            const glm::vec3 center = bounds.center();
+            const glm::vec3 extents = bounds.extents();
+
+            m_entities.emplace_back(entity.id());
+            m_meshes.emplace_back(meshRenderer.mesh);
+            m_worldMatrices.emplace_back(world.matrix);
+            m_centerX.emplace_back(center.x);
+            m_centerY.emplace_back(center.y);
+            m_centerZ.emplace_back(center.z);
+            m_radius.emplace_back(glm::length(extents));
+            m_extentX.emplace_back(extents.x);
+            m_extentY.emplace_back(extents.y);
+            m_extentZ.emplace_back(extents.z);
+        });
+}
+
+}  // namespace avenir::scene
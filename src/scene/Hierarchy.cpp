@@ -0,0 +1,22 @@
+#include "avenir/scene/Hierarchy.hpp"
+
+#include "avenir/scene/Scene.hpp"
+
+namespace avenir::scene {
+
+EntityId ChildRange::Iterator::operator*() const {
+    return {m_index, m_scene->m_entities[m_index].generation};
+}
+
+ChildRange::Iterator &ChildRange::Iterator::operator++() {
+    m_index = m_scene->m_hierarchy[m_index].nextSibling;
+    return *this;
+}
+
+ChildRange::Iterator ChildRange::Iterator::operator++(int) {
+    Iterator previous = *this;
+    ++*this;
+    return previous;
+}
+
+}  // namespace avenir::scene
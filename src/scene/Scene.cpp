@@ -1,73 +1,1101 @@
 #include "avenir/scene/Scene.hpp"
 
-#include "avenir/avenir.hpp"
+#include "avenir/jobs/JobSystem.hpp"
+#include "avenir/scene/components/Camera.hpp"
+#include "avenir/scene/components/MeshRenderer.hpp"
+#include "avenir/scene/components/Transform.hpp"
+#include "avenir/scene/components/WorldTransform.hpp"
 
+#include <algorithm>
 #include <iostream>
-#include <ranges>
+#include <mutex>
+#include <tuple>
 
 namespace avenir::scene {
 
-Entity &Scene::createEntity() {
-    static uint32_t id = 0;
-    auto [it, _] = m_entities.try_emplace(id, Entity(id));
+namespace {
 
-    id++;
+// Below this many entities a threaded hierarchy pass costs more than it saves.
+constexpr uint32_t kParallelTransformThreshold = 8192;
+// Minimum number of entities handed to each job.
+constexpr uint32_t kParallelTransformBatch = 2048;
+// Minimum number of chunks handed to each job building local matrices.
+constexpr uint32_t kParallelLocalMatrixBatch = 8;
+// A pass whose dirty subtrees hold at most this fraction of the live
+// entities walks just those subtrees instead of the whole scene.
+constexpr uint32_t kSparseTransformFraction = 8;
 
-    return it->second;
+}  // namespace
+
+Scene::Scene(jobs::JobSystem &jobSystem) : m_jobSystem(&jobSystem) {}
+
+Entity Scene::createEntity() {
+    uint32_t index;
+    if (!m_freeIndices.empty()) {
+        index = m_freeIndices.back();
+        m_freeIndices.pop_back();
+    } else {
+        index = static_cast<uint32_t>(m_entities.size());
+        m_entities.emplace_back();
+        m_hierarchy.emplace_back();
+    }
+
+    EntityRecord &record = m_entities[index];
+    Archetype &transformArchetype =
+        archetype({&componentInfo<components::Transform>(),
+                   &componentInfo<components::WorldTransform>()});
+    record.archetype = &transformArchetype;
+    record.row = transformArchetype.pushRow(index, m_changeTick);
+    std::construct_at(&recordComponent<components::Transform>(record));
+    std::construct_at(&recordComponent<components::WorldTransform>(record));
+
+    queueTransformUpdate(index);
+    m_hierarchyOrderDirty = true;
+
+    return {*this, EntityId{index, record.generation}};
+}
+
+std::vector<EntityId> Scene::instantiate(
+    const EntityId prefab, const uint32_t count,
+    const std::span<const components::Transform> rootTransforms) {
+    if (!isValid(prefab)) {
+        throw std::runtime_error("Error: Entity does not exist in scene!\n");
+    }
+
+    if (!rootTransforms.empty() && rootTransforms.size() != count) {
+        throw std::runtime_error(
+            "Error: Expected one root transform per prefab instance!\n");
+    }
+
+    if (count == 0) {
+        return {};
+    }
+
+    // Flatten the prefab breadth-first so every parent precedes its children.
+    std::vector<uint32_t> nodes = {prefab.index};
+    std::vector<uint32_t> nodeParents = {0};
+    for (uint32_t node = 0; node < nodes.size(); node++) {
+        const EntityRecord &record = m_entities[nodes[node]];
+        for (const ComponentInfo *info : record.archetype->components()) {
+            if (!info->copyFill) {
+                std::ostringstream errorMessage;
+                errorMessage << "Error: Prefab component cannot be copied: "
+                             << info->name << "\n";
+
+                throw std::runtime_error(errorMessage.str());
+            }
+        }
+
+        for (uint32_t child = m_hierarchy[nodes[node]].firstChild;
+             child != kNoEntity; child = m_hierarchy[child].nextSibling) {
+            nodes.emplace_back(child);
+            nodeParents.emplace_back(node);
+        }
+    }
+
+    // Copy k of node n lives at slot indices[n * count + k].
+    std::vector<uint32_t> indices(nodes.size() * count);
+    const std::size_t reused = std::min(indices.size(), m_freeIndices.size());
+    for (std::size_t i = 0; i < reused; i++) {
+        indices[i] = m_freeIndices.back();
+        m_freeIndices.pop_back();
+    }
+
+    m_entities.resize(m_entities.size() + indices.size() - reused);
+    m_hierarchy.resize(m_entities.size());
+    for (std::size_t i = reused; i < indices.size(); i++) {
+        indices[i] = static_cast<uint32_t>(m_entities.size() -
+                                           (indices.size() - i));
+    }
+
+    for (uint32_t node = 0; node < nodes.size(); node++) {
+        const EntityRecord &source = m_entities[nodes[node]];
+        Archetype &archetype = *source.archetype;
+        const std::span<const uint32_t> copies(&indices[node * count], count);
+
+        const uint32_t firstRow = archetype.pushRows(copies, m_changeTick);
+        for (std::size_t column = 0; column < archetype.components().size();
+             column++) {
+            archetype.fillColumn(
+                column, firstRow, count,
+                std::as_const(archetype).componentAt(column, source.row));
+        }
+
+        for (uint32_t copy = 0; copy < count; copy++) {
+            EntityRecord &record = m_entities[copies[copy]];
+            record.archetype = &archetype;
+            record.row = firstRow + copy;
+            queueTransformUpdate(copies[copy]);
+
+            if (node != 0) {
+                linkToParent(copies[copy],
+                             indices[nodeParents[node] * count + copy]);
+            }
+        }
+    }
+
+    std::vector<EntityId> roots;
+    roots.reserve(count);
+    for (uint32_t copy = 0; copy < count; copy++) {
+        const EntityRecord &record = m_entities[indices[copy]];
+        if (!rootTransforms.empty()) {
+            recordComponent<components::Transform>(record) =
+                rootTransforms[copy];
+        }
+
+        roots.push_back({indices[copy], record.generation});
+    }
+
+    m_hierarchyOrderDirty = true;
+
+    return roots;
 }
 
-std::optional<Entity *> Scene::findEntityById(const uint32_t id) {
-    const auto it = m_entities.find(id);
+std::optional<Entity> Scene::findEntityById(const EntityId id) {
+    if (!isValid(id)) {
+        return std::nullopt;
+    }
+
+    return Entity(*this, id);
+}
 
-    return it != m_entities.end() ? &it->second : nullptr;
+bool Scene::isValid(const EntityId id) const {
+    return id.index < m_entities.size() &&
+           m_entities[id.index].generation == id.generation &&
+           m_entities[id.index].archetype != nullptr;
 }
 
-void Scene::setEntityParent(const uint32_t child,
-                            const std::optional<uint32_t> parent) {
-    const std::optional<Entity *> entity = findEntityById(child);
+void Scene::setEntityParent(const EntityId child,
+                            const std::optional<EntityId> parent) {
+    if (!isValid(child)) {
+        throw std::runtime_error("Error: Entity does not exist in scene!\n");
+    }
+
     if (parent && (*parent == child)) {
         throw std::runtime_error("Error: Entity cannot parent itself!\n");
     }
 
-    if (entity.value()->parent()) {
-        std::optional<Entity *> previousParent =
-            findEntityById(*entity.value()->parent());
-        previousParent.value()->removeChild(child);
+    if (parent && !isValid(*parent)) {
+        throw std::runtime_error("Error: Entity does not exist in scene!\n");
     }
 
-    entity.value()->setParent(parent);
+    if (parent && isAncestor(child.index, parent->index)) {
+        throw std::runtime_error(
+            "Error: Entity cannot be parented to its own descendant!\n");
+    }
+
+    const uint32_t parentIndex = parent ? parent->index : kNoEntity;
+    if (m_hierarchy[child.index].parent == parentIndex) {
+        return;
+    }
 
+    unlinkFromParent(child.index);
     if (parent) {
-        const std::optional<Entity *> newParent = findEntityById(*parent);
-        newParent.value()->addChild(child);
+        linkToParent(child.index, parentIndex);
     }
+
+    queueTransformUpdate(child.index);
+    m_hierarchyOrderDirty = true;
 }
 
-void Scene::detachEntityFromParent(uint32_t child) {
+void Scene::detachEntityFromParent(const EntityId child) {
     setEntityParent(child, std::nullopt);
 }
 
-glm::mat4 Scene::entityWorldMatrix(const uint32_t id) {
-    const std::optional<Entity *> entity = findEntityById(id);
-    const auto &entityTransform =
-        entity.value()->component<avenir::scene::components::Transform>();
+void Scene::destroyEntity(const EntityId id) {
+    EntityRecord &record = entityRecord(id);
+
+    // Children outlive their parent and become roots.
+    HierarchyLinks &links = m_hierarchy[id.index];
+    uint32_t child = links.firstChild;
+    while (child != kNoEntity) {
+        HierarchyLinks &childLinks = m_hierarchy[child];
+        const uint32_t next = childLinks.nextSibling;
+        childLinks.parent = kNoEntity;
+        childLinks.previousSibling = kNoEntity;
+        childLinks.nextSibling = kNoEntity;
+        queueTransformUpdate(child);
+        child = next;
+    }
+    links.firstChild = kNoEntity;
+    links.lastChild = kNoEntity;
+    links.childCount = 0;
+
+    unlinkFromParent(id.index);
+    destroySpatialProxy(record);
+
+    Archetype &archetype = *record.archetype;
+    archetype.destroyRow(record.row);
+    if (const std::optional<uint32_t> relocated =
+            archetype.eraseRow(record.row)) {
+        m_entities[*relocated].row = record.row;
+    }
+
+    // Bumping the generation invalidates every outstanding handle to the slot.
+    record.archetype = nullptr;
+    record.generation++;
+    m_freeIndices.emplace_back(id.index);
+    m_hierarchyOrderDirty = true;
+}
+
+void Scene::destroyEntities(const std::span<const EntityId> ids) {
+    for (const EntityId id : ids) {
+        if (isValid(id)) {
+            destroyEntity(id);
+        }
+    }
+}
+
+void Scene::applyCommands(const std::span<SceneCommandBuffer *const> buffers) {
+    using CommandType = SceneCommandBuffer::CommandType;
+
+    const auto resolve = [](const SceneCommandBuffer &buffer,
+                            const SceneCommandBuffer::Target target) {
+        return target.isPending ? buffer.m_created[target.id.index] : target.id;
+    };
+
+    // Commands hand their values to the scene as they run, so the buffers
+    // are cleared even if one throws part way through the batch.
+    struct ClearOnExit {
+        Scene &scene;
+        std::span<SceneCommandBuffer *const> buffers;
+
+        ~ClearOnExit() {
+            scene.m_commandQueue.clear();
+            for (SceneCommandBuffer *buffer : buffers) {
+                buffer->clear();
+            }
+        }
+    } clearOnExit{*this, buffers};
+
+    for (SceneCommandBuffer *buffer : buffers) {
+        buffer->m_created.clear();
+        for (uint32_t i = 0; i < buffer->m_pendingCount; i++) {
+            buffer->m_created.emplace_back(createEntity().id());
+        }
+    }
+
+    m_commandQueue.clear();
+    for (SceneCommandBuffer *buffer : buffers) {
+        for (SceneCommandBuffer::Command &command : buffer->m_commands) {
+            std::optional<EntityId> parent;
+            if (command.parent) {
+                parent = resolve(*buffer, *command.parent);
+            }
+
+            m_commandQueue.push_back(
+                {&command, resolve(*buffer, command.target), parent,
+                 static_cast<uint32_t>(m_commandQueue.size())});
+        }
+    }
+
+    // Adds and removes share a phase so the recorded order of an add and
+    // remove of the same component on the same entity is preserved.
+    const auto phase = [](const CommandType type) {
+        switch (type) {
+            case CommandType::eAddComponent:
+            case CommandType::eRemoveComponent:
+                return 0;
+            case CommandType::eSetParent:
+                return 1;
+            case CommandType::eDestroy:
+                return 2;
+        }
+
+        return 3;
+    };
+
+    std::ranges::sort(m_commandQueue, [&](const QueuedCommand &lhs,
+                                          const QueuedCommand &rhs) {
+        const auto key = [&](const QueuedCommand &queued) {
+            return std::tuple(
+                phase(queued.command->type),
+                queued.command->component ? queued.command->component->id : 0,
+                queued.target.index, queued.sequence);
+        };
+
+        return key(lhs) < key(rhs);
+    });
+
+    for (const QueuedCommand &queued : m_commandQueue) {
+        SceneCommandBuffer::Command &command = *queued.command;
+        if (!isValid(queued.target)) {
+            continue;
+        }
+
+        switch (command.type) {
+            case CommandType::eAddComponent: {
+                const ComponentInfo &info = *command.component;
+                void *slot;
+                if (const auto existing =
+                        entityRecord(queued.target).archetype->columnIndex(
+                            info)) {
+                    const EntityRecord &record = entityRecord(queued.target);
+                    slot = record.archetype->componentAt(*existing, record.row);
+                    info.destroy(slot);
+                    record.archetype->setChangeTick(*existing, record.row,
+                                                    m_changeTick);
+                } else {
+                    slot = insertComponent(queued.target, info);
+                }
+
+                info.moveConstruct(slot, command.value);
+                info.destroy(command.value);
+                command.value = nullptr;
+
+                if (info.id == componentTypeId<components::Transform>()) {
+                    markTransformDirty(queued.target);
+                }
+                break;
+            }
+            case CommandType::eRemoveComponent:
+                if (entityRecord(queued.target).archetype->contains(
+                        *command.component)) {
+                    eraseComponent(queued.target, *command.component);
+                }
+                break;
+            case CommandType::eSetParent:
+                // Reparents that would form a cycle are dropped like those
+                // aimed at destroyed entities.
+                if (!queued.parent) {
+                    setEntityParent(queued.target, std::nullopt);
+                } else if (isValid(*queued.parent) &&
+                           queued.parent->index != queued.target.index &&
+                           !isAncestor(queued.target.index,
+                                       queued.parent->index)) {
+                    setEntityParent(queued.target, queued.parent);
+                }
+                break;
+            case CommandType::eDestroy:
+                destroyEntity(queued.target);
+                break;
+        }
+    }
+}
+
+void Scene::applyCommands(SceneCommandBuffer &buffer) {
+    SceneCommandBuffer *buffers[] = {&buffer};
+    applyCommands(buffers);
+}
+
+std::optional<EntityId> Scene::entityParent(const EntityId id) const {
+    if (!isValid(id)) {
+        throw std::runtime_error("Error: Entity does not exist in scene!\n");
+    }
+
+    const uint32_t parent = m_hierarchy[id.index].parent;
+    if (parent == kNoEntity) {
+        return std::nullopt;
+    }
+
+    return EntityId{parent, m_entities[parent].generation};
+}
+
+ChildRange Scene::entityChildren(const EntityId id) const {
+    if (!isValid(id)) {
+        throw std::runtime_error("Error: Entity does not exist in scene!\n");
+    }
+
+    return {*this, m_hierarchy[id.index]};
+}
+
+void Scene::listComponents(const EntityId id) const {
+    std::cout << "[Entity] id: " << id.index << " (generation "
+              << id.generation << "), Components:\n";
+    for (const ComponentInfo *info : entityRecord(id).archetype->components()) {
+        std::cout << "\t\t " << info->name << "\n";
+    }
+}
+
+const std::vector<std::unique_ptr<Archetype>> &Scene::archetypes() const {
+    return m_archetypes;
+}
+
+void Scene::markTransformDirty(const EntityId id) {
+    if (!isValid(id)) {
+        throw std::runtime_error("Error: Entity does not exist in scene!\n");
+    }
+
+    queueTransformUpdate(id.index);
+}
+
+void Scene::updateWorldTransforms() {
+    if (m_dirtyTransforms.empty()) {
+        return;
+    }
+
+    m_spatialIndexDirty = true;
+    if (!updateDirtySubtrees()) {
+        updateAllWorldTransforms();
+    }
+
+    for (const uint32_t index : m_dirtyTransforms) {
+        m_entities[index].worldTransformDirty = false;
+    }
+    m_dirtyTransforms.clear();
+}
+
+void Scene::updateAllWorldTransforms() {
+    if (m_hierarchyOrderDirty) {
+        rebuildHierarchyOrder();
+    }
+
+    m_transformChunks.clear();
+    for (Archetype *archetype :
+         matchingArchetypes(componentMask<components::Transform,
+                                          components::WorldTransform>())) {
+        for (std::size_t chunk = 0; chunk < archetype->chunkCount(); chunk++) {
+            m_transformChunks.emplace_back(archetype, chunk);
+        }
+    }
+
+    const auto flagRange = [this](const uint32_t begin, const uint32_t end) {
+        for (uint32_t i = begin; i < end; i++) {
+            flagWorldTransformChange(m_hierarchyOrder[i]);
+        }
+    };
+    const auto localRange = [this](const uint32_t begin, const uint32_t end) {
+        for (uint32_t i = begin; i < end; i++) {
+            updateLocalMatrices(*m_transformChunks[i].first,
+                                m_transformChunks[i].second);
+        }
+    };
+    const auto updateRange = [this](const uint32_t begin, const uint32_t end) {
+        for (uint32_t i = begin; i < end; i++) {
+            updateWorldTransform(m_hierarchyOrder[i]);
+        }
+    };
+
+    // Roots are finished by the chunk pass; only children need composing.
+    const auto entityCount = static_cast<uint32_t>(m_hierarchyOrder.size());
+    const auto chunkCount = static_cast<uint32_t>(m_transformChunks.size());
+    if (entityCount < kParallelTransformThreshold) {
+        flagRange(0, entityCount);
+        localRange(0, chunkCount);
+        if (m_hierarchyLevelOffsets.size() > 1) {
+            updateRange(m_hierarchyLevelOffsets[1], entityCount);
+        }
+        return;
+    }
+
+    // The hierarchy passes split each level across the job system and finish
+    // it before the next starts, so no child is processed before its parent.
+    // Chunks are independent of one another.
+    jobs::JobSystem &jobSystem =
+        m_jobSystem ? *m_jobSystem : jobs::JobSystem::shared();
+    const auto eachLevel = [&](const std::size_t firstLevel,
+                               const auto &range) {
+        for (std::size_t level = firstLevel;
+             level + 1 < m_hierarchyLevelOffsets.size(); level++) {
+            jobSystem.parallelFor(m_hierarchyLevelOffsets[level],
+                                  m_hierarchyLevelOffsets[level + 1],
+                                  kParallelTransformBatch, range);
+        }
+    };
+
+    eachLevel(0, flagRange);
+    jobSystem.parallelFor(0, chunkCount, kParallelLocalMatrixBatch,
+                          localRange);
+    eachLevel(1, updateRange);
+}
+
+void Scene::updateSpatialIndex() {
+    updateWorldTransforms();
+
+    const ComponentInfo &worldInfo =
+        componentInfo<components::WorldTransform>();
+    const ComponentInfo &meshRendererInfo =
+        componentInfo<components::MeshRenderer>();
+
+    // Either component changing moves the world bounds, so a row is refitted
+    // when either of its ticks is recent. Chunks where neither column was
+    // written are skipped outright.
+    for (Archetype *archetype :
+         matchingArchetypes(componentMask<components::WorldTransform,
+                                          components::MeshRenderer>())) {
+        const std::size_t worldColumn = *archetype->columnIndex(worldInfo);
+        const std::size_t meshRendererColumn =
+            *archetype->columnIndex(meshRendererInfo);
+
+        for (std::size_t chunk = 0; chunk < archetype->chunkCount(); chunk++) {
+            if (archetype->chunkChangeTick(chunk, worldColumn) <
+                    m_spatialIndexTick &&
+                archetype->chunkChangeTick(chunk, meshRendererColumn) <
+                    m_spatialIndexTick) {
+                continue;
+            }
+
+            const std::span<const uint32_t> entities =
+                archetype->entities(chunk);
+            const std::span<const uint32_t> worldTicks =
+                archetype->changeTicks(chunk, worldColumn);
+            const std::span<const uint32_t> meshRendererTicks =
+                archetype->changeTicks(chunk, meshRendererColumn);
+            const std::span<const components::WorldTransform> worlds =
+                std::as_const(*archetype)
+                    .components<components::WorldTransform>(chunk);
+            const std::span<const components::MeshRenderer> meshRenderers =
+                std::as_const(*archetype)
+                    .components<components::MeshRenderer>(chunk);
+
+            for (uint32_t i = 0; i < entities.size(); i++) {
+                if (worldTicks[i] < m_spatialIndexTick &&
+                    meshRendererTicks[i] < m_spatialIndexTick) {
+                    continue;
+                }
+
+                const Aabb worldBounds =
+                    meshRenderers[i].localBounds.transformed(worlds[i].matrix);
+                EntityRecord &record = m_entities[entities[i]];
+                if (record.spatialProxy == DynamicAabbTree::kNullNode) {
+                    record.spatialProxy =
+                        m_spatialIndex.createProxy(worldBounds, entities[i]);
+                } else {
+                    m_spatialIndex.moveProxy(record.spatialProxy, worldBounds);
+                }
+            }
+        }
+    }
+
+    m_spatialIndexTick = m_changeTick;
+    m_spatialIndexDirty = false;
+}
+
+const DynamicAabbTree &Scene::spatialIndex() const { return m_spatialIndex; }
+
+uint32_t Scene::changeTick() const { return m_changeTick; }
+
+uint32_t Scene::advanceChangeTick() {
+    // Nothing else is running between frames, so chunks replaced by
+    // copy-on-write during this one can no longer be in use by the scene.
+    for (const std::unique_ptr<Archetype> &archetype : m_archetypes) {
+        archetype->releaseRetiredChunks();
+    }
+
+    return ++m_changeTick;
+}
+
+SceneSnapshot Scene::snapshot() {
+    SceneSnapshot snapshot;
+    captureSnapshot(snapshot);
+
+    return snapshot;
+}
+
+void Scene::captureSnapshot(SceneSnapshot &snapshot) {
+    snapshot.reset();
+    updateWorldTransforms();
+
+    for (const std::unique_ptr<Archetype> &archetype : m_archetypes) {
+        if (archetype->size() == 0 || archetype->isShareable()) {
+            continue;
+        }
+
+        for (const ComponentInfo *info : archetype->components()) {
+            if (!info->copyConstruct) {
+                std::ostringstream errorMessage;
+                errorMessage << "Error: Cannot snapshot component that is not "
+                                "copy constructible: "
+                             << info->name << "\n";
+
+                throw std::runtime_error(errorMessage.str());
+            }
+        }
+    }
+
+    snapshot.m_changeTick = m_changeTick;
+    snapshot.m_archetypes.resize(m_archetypes.size());
+    snapshot.m_entities.resize(m_entities.size());
+
+    for (uint32_t index = 0; index < m_archetypes.size(); index++) {
+        Archetype &archetype = *m_archetypes[index];
+        archetype.releaseRetiredChunks();
 
-    const glm::mat4 localMatrix = entityTransform.localMatrix();
-    if (!entity.value()->parent().has_value()) {
-        return localMatrix;
+        SceneSnapshot::SharedArchetype &shared = snapshot.m_archetypes[index];
+        shared.archetype = &archetype;
+        shared.size = archetype.size();
+        for (std::size_t chunk = 0; chunk < archetype.chunkCount(); chunk++) {
+            shared.chunks.emplace_back(archetype.shareChunk(chunk));
+
+            const std::span<const uint32_t> entities =
+                archetype.entities(chunk);
+            const uint32_t firstRow =
+                static_cast<uint32_t>(chunk) * archetype.chunkCapacity();
+            for (uint32_t i = 0; i < entities.size(); i++) {
+                snapshot.m_entities[entities[i]] = {
+                    index, firstRow + i, m_entities[entities[i]].generation};
+            }
+        }
     }
+}
+
+const AllocationStats &Scene::allocationStats() const {
+    return m_chunkAllocator.stats();
+}
+
+glm::mat4 Scene::entityWorldMatrix(const EntityId id) {
+    updateWorldTransforms();
 
-    return entityWorldMatrix(*entity.value()->parent()) * localMatrix;
+    return std::as_const(*this).component<components::WorldTransform>(id)
+        .matrix;
 }
 
-glm::mat4 Scene::entityInverseWorldMatrix(const uint32_t id) {
-    return glm::inverse(entityWorldMatrix(id));
+glm::mat4 Scene::entityInverseWorldMatrix(const EntityId id) {
+    updateWorldTransforms();
+
+    return std::as_const(*this).component<components::WorldTransform>(id)
+        .inverseMatrix;
+}
+
+std::optional<EntityId> Scene::primaryCamera() {
+    std::optional<EntityId> result;
+    each<const components::Camera>(
+        [&](const Entity entity, const components::Camera &camera) {
+            if (!result && camera.isPrimary) {
+                result = entity.id();
+            }
+        });
+
+    return result;
 }
 
 void Scene::printEntityIds() {
-    for (const auto &key : m_entities | std::views::keys) {
-        std::cout << "[Scene] Entity ID: " << key << "\n";
+    for (uint32_t index = 0; index < m_entities.size(); index++) {
+        if (m_entities[index].archetype) {
+            std::cout << "[Scene] Entity ID: " << index << " (generation "
+                      << m_entities[index].generation << ")\n";
+        }
+    }
+}
+
+void Scene::linkToParent(const uint32_t child, const uint32_t parent) {
+    HierarchyLinks &links = m_hierarchy[child];
+    HierarchyLinks &parentLinks = m_hierarchy[parent];
+
+    links.parent = parent;
+    links.previousSibling = parentLinks.lastChild;
+    links.nextSibling = kNoEntity;
+
+    if (parentLinks.lastChild != kNoEntity) {
+        m_hierarchy[parentLinks.lastChild].nextSibling = child;
+    } else {
+        parentLinks.firstChild = child;
+    }
+
+    parentLinks.lastChild = child;
+    parentLinks.childCount++;
+}
+
+void Scene::unlinkFromParent(const uint32_t index) {
+    HierarchyLinks &links = m_hierarchy[index];
+    if (links.parent == kNoEntity) {
+        return;
+    }
+
+    HierarchyLinks &parentLinks = m_hierarchy[links.parent];
+    if (links.previousSibling != kNoEntity) {
+        m_hierarchy[links.previousSibling].nextSibling = links.nextSibling;
+    } else {
+        parentLinks.firstChild = links.nextSibling;
+    }
+
+    if (links.nextSibling != kNoEntity) {
+        m_hierarchy[links.nextSibling].previousSibling = links.previousSibling;
+    } else {
+        parentLinks.lastChild = links.previousSibling;
+    }
+
+    parentLinks.childCount--;
+    links.parent = kNoEntity;
+    links.previousSibling = kNoEntity;
+    links.nextSibling = kNoEntity;
+}
+
+bool Scene::isAncestor(const uint32_t ancestor, const uint32_t index) const {
+    for (uint32_t current = m_hierarchy[index].parent; current != kNoEntity;
+         current = m_hierarchy[current].parent) {
+        if (current == ancestor) {
+            return true;
+        }
     }
+
+    return false;
+}
+
+void Scene::rebuildHierarchyOrder() {
+    m_hierarchyOrder.clear();
+    m_hierarchyLevelOffsets.assign(1, 0);
+
+    for (uint32_t index = 0; index < m_entities.size(); index++) {
+        if (m_entities[index].archetype &&
+            m_hierarchy[index].parent == kNoEntity) {
+            m_hierarchyOrder.emplace_back(index);
+        }
+    }
+
+    std::size_t levelBegin = 0;
+    while (levelBegin < m_hierarchyOrder.size()) {
+        const std::size_t levelEnd = m_hierarchyOrder.size();
+        m_hierarchyLevelOffsets.emplace_back(static_cast<uint32_t>(levelEnd));
+
+        for (std::size_t i = levelBegin; i < levelEnd; i++) {
+            for (uint32_t child = m_hierarchy[m_hierarchyOrder[i]].firstChild;
+                 child != kNoEntity; child = m_hierarchy[child].nextSibling) {
+                m_hierarchyOrder.emplace_back(child);
+            }
+        }
+
+        levelBegin = levelEnd;
+    }
+
+    m_hierarchyOrderDirty = false;
+}
+
+void Scene::refreshSpatialIndex() {
+    if (m_spatialIndexDirty || !m_dirtyTransforms.empty() ||
+        m_spatialIndexTick != m_changeTick) {
+        updateSpatialIndex();
+    }
+}
+
+void Scene::destroySpatialProxy(EntityRecord &record) {
+    if (record.spatialProxy != DynamicAabbTree::kNullNode) {
+        m_spatialIndex.destroyProxy(record.spatialProxy);
+        record.spatialProxy = DynamicAabbTree::kNullNode;
+    }
+}
+
+bool Scene::updateDirtySubtrees() {
+    const auto liveCount =
+        static_cast<uint32_t>(m_entities.size() - m_freeIndices.size());
+    const uint32_t budget = liveCount / kSparseTransformFraction;
+    if (m_dirtyTransforms.size() > budget) {
+        return false;
+    }
+
+    // Walks start only at dirty entities without a dirty ancestor, so they
+    // cover disjoint subtrees, each visited parent before child.
+    m_dirtySubtrees.clear();
+    for (const uint32_t root : m_dirtyTransforms) {
+        if (!m_entities[root].archetype) {
+            continue;
+        }
+
+        bool covered = false;
+        for (uint32_t ancestor = m_hierarchy[root].parent;
+             ancestor != kNoEntity && !covered;
+             ancestor = m_hierarchy[ancestor].parent) {
+            covered = m_entities[ancestor].worldTransformDirty;
+        }
+        if (covered) {
+            continue;
+        }
+
+        uint32_t index = root;
+        while (true) {
+            if (m_dirtySubtrees.size() == budget) {
+                return false;
+            }
+            m_dirtySubtrees.emplace_back(index);
+
+            if (m_hierarchy[index].firstChild != kNoEntity) {
+                index = m_hierarchy[index].firstChild;
+                continue;
+            }
+            while (index != root &&
+                   m_hierarchy[index].nextSibling == kNoEntity) {
+                index = m_hierarchy[index].parent;
+            }
+            if (index == root) {
+                break;
+            }
+            index = m_hierarchy[index].nextSibling;
+        }
+    }
+
+    for (const uint32_t index : m_dirtySubtrees) {
+        updateDirtyTransform(index);
+    }
+
+    return true;
+}
+
+void Scene::updateDirtyTransform(const uint32_t index) {
+    const EntityRecord &record = m_entities[index];
+    Archetype &archetype = *record.archetype;
+
+    // Stamping may unshare the chunk from snapshots, so the components are
+    // looked up afterwards.
+    archetype.setChangeTick(
+        *archetype.columnIndex(componentInfo<components::WorldTransform>()),
+        record.row, m_changeTick);
+    auto &world = recordComponent<components::WorldTransform>(record);
+    const auto &transform =
+        std::as_const(*this).recordComponent<components::Transform>(record);
+    world.matrix = transform.localMatrix();
+    world.inverseMatrix = transform.inverseLocalMatrix();
+
+    if (const uint32_t parent = m_hierarchy[index].parent;
+        parent != kNoEntity) {
+        const auto &parentWorld =
+            std::as_const(*this).recordComponent<components::WorldTransform>(
+                m_entities[parent]);
+        world.matrix = parentWorld.matrix * world.matrix;
+        world.inverseMatrix = world.inverseMatrix * parentWorld.inverseMatrix;
+    }
+}
+
+void Scene::flagWorldTransformChange(const uint32_t index) {
+    EntityRecord &record = m_entities[index];
+    const uint32_t parent = m_hierarchy[index].parent;
+    record.worldTransformChanged =
+        record.worldTransformDirty ||
+        (parent != kNoEntity && m_entities[parent].worldTransformChanged);
+}
+
+void Scene::updateLocalMatrices(Archetype &archetype, const std::size_t chunk) {
+    // Per-thread scratch, reused across chunks and frames: the chunk rows to
+    // rebuild, their transforms as ten float streams, and the results.
+    thread_local std::vector<uint32_t> rows;
+    thread_local std::vector<float> streams;
+    thread_local std::vector<glm::mat4> matrices;
+
+    const std::span<const uint32_t> entities = archetype.entities(chunk);
+    rows.clear();
+    for (uint32_t i = 0; i < entities.size(); i++) {
+        if (m_entities[entities[i]].worldTransformChanged) {
+            rows.emplace_back(i);
+        }
+    }
+
+    if (rows.empty()) {
+        return;
+    }
+
+    const std::size_t count = rows.size();
+    streams.resize(count * 10);
+    matrices.resize(count);
+
+    std::span<const components::Transform> transforms =
+        std::as_const(archetype).components<components::Transform>(chunk);
+    float *stream = streams.data();
+    for (std::size_t i = 0; i < count; i++) {
+        const components::Transform &transform = transforms[rows[i]];
+        stream[i] = transform.position.x;
+        stream[count + i] = transform.position.y;
+        stream[count * 2 + i] = transform.position.z;
+        stream[count * 3 + i] = transform.rotation.x;
+        stream[count * 4 + i] = transform.rotation.y;
+        stream[count * 5 + i] = transform.rotation.z;
+        stream[count * 6 + i] = transform.rotation.w;
+        stream[count * 7 + i] = transform.scale.x;
+        stream[count * 8 + i] = transform.scale.y;
+        stream[count * 9 + i] = transform.scale.z;
+    }
+
+    const auto streamAt = [&](const std::size_t index) {
+        return std::span<const float>(stream + count * index, count);
+    };
+    components::Transform::localMatrices(
+        {streamAt(0), streamAt(1), streamAt(2), streamAt(3), streamAt(4),
+         streamAt(5), streamAt(6), streamAt(7), streamAt(8), streamAt(9)},
+        matrices);
+
+    // The world matrices hold the local ones until updateWorldTransform()
+    // composes them with the parent's. Writing may unshare the chunk from
+    // snapshots, so the transforms are looked up again afterwards.
+    const std::size_t worldColumn = *archetype.columnIndex(
+        componentInfo<components::WorldTransform>());
+    const std::span<components::WorldTransform> worlds =
+        archetype.components<components::WorldTransform>(chunk);
+    transforms =
+        std::as_const(archetype).components<components::Transform>(chunk);
+    const auto firstRow =
+        static_cast<uint32_t>(chunk * archetype.chunkCapacity());
+    for (std::size_t i = 0; i < count; i++) {
+        components::WorldTransform &world = worlds[rows[i]];
+        world.matrix = matrices[i];
+        world.inverseMatrix = transforms[rows[i]].inverseLocalMatrix();
+        archetype.setChangeTick(worldColumn, firstRow + rows[i], m_changeTick);
+    }
+}
+
+void Scene::updateWorldTransform(const uint32_t index) {
+    const EntityRecord &record = m_entities[index];
+    const uint32_t parent = m_hierarchy[index].parent;
+    if (!record.worldTransformChanged || parent == kNoEntity) {
+        return;
+    }
+
+    // The inverse composes in reverse order, so it stays built from
+    // closed-form TRS inverses at every level.
+    auto &world = recordComponent<components::WorldTransform>(record);
+    const auto &parentWorld =
+        std::as_const(*this).recordComponent<components::WorldTransform>(
+            m_entities[parent]);
+    world.matrix = parentWorld.matrix * world.matrix;
+    world.inverseMatrix = world.inverseMatrix * parentWorld.inverseMatrix;
+}
+
+Scene::EntityRecord &Scene::entityRecord(const EntityId id) {
+    return const_cast<EntityRecord &>(std::as_const(*this).entityRecord(id));
+}
+
+const Scene::EntityRecord &Scene::entityRecord(const EntityId id) const {
+    if (!isValid(id)) {
+        throw std::runtime_error("Error: Entity does not exist in scene!\n");
+    }
+
+    return m_entities[id.index];
+}
+
+const std::vector<Archetype *> &Scene::matchingArchetypes(
+    const ComponentMask &mask) {
+    // Archetypes are only created by structural edits, which systems defer
+    // to command buffers, so while systems run a cache that is up to date
+    // stays that way. Map nodes do not move on rehash, so the returned
+    // vector outlives the lock.
+    {
+        std::shared_lock lock(m_queriesMutex);
+        if (const auto it = m_queries.find(mask);
+            it != m_queries.end() &&
+            it->second.checkedArchetypes == m_archetypes.size()) {
+            return it->second.archetypes;
+        }
+    }
+
+    std::unique_lock lock(m_queriesMutex);
+    QueryCache &query = m_queries[mask];
+
+    for (; query.checkedArchetypes < m_archetypes.size();
+         query.checkedArchetypes++) {
+        Archetype *archetype = m_archetypes[query.checkedArchetypes].get();
+        if ((archetype->mask() & mask) == mask) {
+            query.archetypes.emplace_back(archetype);
+        }
+    }
+
+    return query.archetypes;
+}
+
+void *Scene::componentPointer(const EntityId id, const ComponentInfo &info) {
+    const EntityRecord &record = entityRecord(id);
+    const std::optional<std::size_t> column =
+        record.archetype->columnIndex(info);
+    if (!column) {
+        throw std::runtime_error("Entity does not have requested component!\n");
+    }
+
+    // Handing out mutable access counts as a write. Stamping unshares the
+    // chunk from snapshots, so the address is taken afterwards.
+    record.archetype->setChangeTick(*column, record.row, m_changeTick);
+
+    return record.archetype->componentAt(*column, record.row);
+}
+
+const void *Scene::componentPointer(const EntityId id,
+                                    const ComponentInfo &info) const {
+    const EntityRecord &record = entityRecord(id);
+    const Archetype &archetype = *record.archetype;
+    const std::optional<std::size_t> column = archetype.columnIndex(info);
+    if (!column) {
+        throw std::runtime_error("Entity does not have requested component!\n");
+    }
+
+    // Read-only; does not unshare the chunk from snapshots.
+    return archetype.componentAt(*column, record.row);
+}
+
+Archetype &Scene::archetype(std::vector<const ComponentInfo *> components) {
+    ComponentMask mask;
+    for (const ComponentInfo *info : components) {
+        mask.set(info->id);
+    }
+
+    if (const auto it = m_archetypesBySignature.find(mask);
+        it != m_archetypesBySignature.end()) {
+        return *it->second;
+    }
+
+    std::ranges::sort(components, std::less{}, &ComponentInfo::id);
+
+    auto &created = m_archetypes.emplace_back(
+        std::make_unique<Archetype>(std::move(components), m_chunkAllocator));
+    m_archetypesBySignature.emplace(mask, created.get());
+
+    return *created;
+}
+
+Archetype &Scene::archetypeWithComponent(Archetype &source,
+                                         const ComponentInfo &info) {
+    if (Archetype *cached = source.addEdge(info)) {
+        return *cached;
+    }
+
+    std::vector<const ComponentInfo *> components = source.components();
+    components.emplace_back(&info);
+
+    Archetype &destination = archetype(std::move(components));
+    source.setAddEdge(info, &destination);
+    destination.setRemoveEdge(info, &source);
+
+    return destination;
+}
+
+Archetype &Scene::archetypeWithoutComponent(Archetype &source,
+                                            const ComponentInfo &info) {
+    if (Archetype *cached = source.removeEdge(info)) {
+        return *cached;
+    }
+
+    std::vector<const ComponentInfo *> components = source.components();
+    std::erase(components, &info);
+
+    Archetype &destination = archetype(std::move(components));
+    source.setRemoveEdge(info, &destination);
+    destination.setAddEdge(info, &source);
+
+    return destination;
+}
+
+void *Scene::insertComponent(const EntityId id, const ComponentInfo &info) {
+    const auto [archetype, row] = moveEntityToArchetype(
+        id, archetypeWithComponent(*entityRecord(id).archetype, info));
+
+    return archetype->componentAt(*archetype->columnIndex(info), row);
+}
+
+void Scene::eraseComponent(const EntityId id, const ComponentInfo &info) {
+    // The hierarchy passes read both from every entity.
+    if (info.id == componentTypeId<components::Transform>() ||
+        info.id == componentTypeId<components::WorldTransform>()) {
+        throw std::runtime_error(
+            "Error: Transform and WorldTransform cannot be removed!\n");
+    }
+
+    moveEntityToArchetype(
+        id, archetypeWithoutComponent(*entityRecord(id).archetype, info));
+
+    if (info.id == componentTypeId<components::MeshRenderer>()) {
+        destroySpatialProxy(m_entities[id.index]);
+    }
+}
+
+std::pair<Archetype *, uint32_t> Scene::moveEntityToArchetype(
+    const EntityId id, Archetype &destination) {
+    EntityRecord &record = entityRecord(id);
+    Archetype &source = *record.archetype;
+
+    const uint32_t row = destination.pushRow(id.index, m_changeTick);
+    source.moveRowTo(record.row, destination, row);
+    if (const std::optional<uint32_t> relocated = source.eraseRow(record.row)) {
+        m_entities[*relocated].row = record.row;
+    }
+
+    record.archetype = &destination;
+    record.row = row;
+
+    return {&destination, row};
 }
 
 }  // namespace avenir::scene
@@ -0,0 +1,83 @@
+#include "avenir/scene/SceneCommandBuffer.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace avenir::scene {
+
+SceneCommandBuffer::~SceneCommandBuffer() { clear(); }
+
+SceneCommandBuffer::PendingEntity SceneCommandBuffer::createEntity() {
+    return PendingEntity{m_pendingCount++};
+}
+
+void SceneCommandBuffer::destroyEntity(const EntityId id) {
+    m_commands.push_back(
+        {CommandType::eDestroy, id, std::nullopt, nullptr, nullptr});
+}
+
+void SceneCommandBuffer::setEntityParent(const Target child,
+                                         const std::optional<Target> parent) {
+    if (parent && parent->isPending == child.isPending &&
+        parent->id == child.id) {
+        throw std::runtime_error("Error: Entity cannot parent itself!\n");
+    }
+
+    m_commands.push_back(
+        {CommandType::eSetParent, child, parent, nullptr, nullptr});
+}
+
+bool SceneCommandBuffer::empty() const {
+    return m_commands.empty() && m_pendingCount == 0;
+}
+
+EntityId SceneCommandBuffer::entity(const PendingEntity pending) const {
+    if (pending.index >= m_created.size()) {
+        throw std::runtime_error(
+            "Error: Pending entity has not been created yet!\n");
+    }
+
+    return m_created[pending.index];
+}
+
+void SceneCommandBuffer::clear() {
+    for (Command &command : m_commands) {
+        if (command.value) {
+            command.component->destroy(command.value);
+        }
+    }
+
+    m_commands.clear();
+    m_pendingCount = 0;
+    m_currentPage = 0;
+    m_pageOffset = 0;
+}
+
+void *SceneCommandBuffer::allocateValue(const std::size_t size,
+                                        const std::size_t alignment) {
+    // Values never move once written, so pages are only ever appended.
+    while (true) {
+        if (m_currentPage == m_pages.size()) {
+            const std::size_t pageSize =
+                std::max(kPageSize, size + alignment);
+            m_pages.push_back(
+                {std::make_unique<std::byte[]>(pageSize), pageSize});
+        }
+
+        Page &page = m_pages[m_currentPage];
+        const auto base = reinterpret_cast<std::uintptr_t>(page.memory.get());
+        const std::uintptr_t address =
+            (base + m_pageOffset + alignment - 1) & ~(alignment - 1);
+        const std::size_t end = address - base + size;
+
+        if (end <= page.size) {
+            m_pageOffset = end;
+            return reinterpret_cast<void *>(address);
+        }
+
+        m_currentPage++;
+        m_pageOffset = 0;
+    }
+}
+
+}  // namespace avenir::scene
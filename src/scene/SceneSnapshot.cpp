@@ -0,0 +1,66 @@
+#include "avenir/scene/SceneSnapshot.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace avenir::scene {
+
+SceneSnapshot::~SceneSnapshot() { reset(); }
+
+SceneSnapshot::SceneSnapshot(SceneSnapshot &&other) noexcept
+    : m_archetypes(std::move(other.m_archetypes)),
+      m_entities(std::move(other.m_entities)),
+      m_changeTick(other.m_changeTick) {
+    other.m_archetypes.clear();
+    other.m_entities.clear();
+}
+
+SceneSnapshot &SceneSnapshot::operator=(SceneSnapshot &&other) noexcept {
+    if (this != &other) {
+        reset();
+        std::swap(m_archetypes, other.m_archetypes);
+        std::swap(m_entities, other.m_entities);
+        m_changeTick = other.m_changeTick;
+    }
+
+    return *this;
+}
+
+void SceneSnapshot::reset() {
+    for (SharedArchetype &shared : m_archetypes) {
+        for (std::size_t chunk = 0; chunk < shared.chunks.size(); chunk++) {
+            shared.archetype->releaseChunk(shared.chunks[chunk],
+                                           chunkRows(shared, chunk));
+        }
+
+        shared.chunks.clear();
+        shared.size = 0;
+    }
+
+    m_entities.clear();
+}
+
+bool SceneSnapshot::empty() const { return m_entities.empty(); }
+
+uint32_t SceneSnapshot::changeTick() const { return m_changeTick; }
+
+bool SceneSnapshot::isValid(const EntityId id) const {
+    return id.index < m_entities.size() &&
+           m_entities[id.index].archetype != kNoArchetype &&
+           m_entities[id.index].generation == id.generation;
+}
+
+uint32_t SceneSnapshot::chunkRows(const SharedArchetype &shared,
+                                  const std::size_t chunk) {
+    const uint32_t capacity = shared.archetype->chunkCapacity();
+
+    return std::min(capacity,
+                    shared.size - static_cast<uint32_t>(chunk) * capacity);
+}
+
+const SceneSnapshot::SharedArchetype &SceneSnapshot::archetypeOf(
+    const EntityId id) const {
+    return m_archetypes[m_entities[id.index].archetype];
+}
+
+}  // namespace avenir::scene
@@ -0,0 +1,157 @@
+#include "avenir/scene/SystemScheduler.hpp"
+
+#include "avenir/scene/Scene.hpp"
+#include "avenir/scene/components/Transform.hpp"
+#include "avenir/scene/components/WorldTransform.hpp"
+
+#include <stdexcept>
+
+namespace avenir::scene {
+
+System::System(std::string name, Function function)
+    : m_name(std::move(name)), m_function(std::move(function)) {}
+
+System &System::runOnMainThread() {
+    m_mainThread = true;
+    return *this;
+}
+
+const std::string &System::name() const { return m_name; }
+
+bool System::conflictsWith(const System &other) const {
+    const auto effectiveWrites = [](const System &system) {
+        ComponentMask writes = system.m_writes;
+        if (writes.test(componentTypeId<components::Transform>())) {
+            writes.set(componentTypeId<components::WorldTransform>());
+        }
+
+        return writes;
+    };
+
+    const ComponentMask writes = effectiveWrites(*this);
+    const ComponentMask otherWrites = effectiveWrites(other);
+
+    return (writes & (other.m_reads | otherWrites)).any() ||
+           (otherWrites & m_reads).any();
+}
+
+SystemScheduler::SystemScheduler(Scene &scene)
+    : SystemScheduler(scene, jobs::JobSystem::shared()) {}
+
+SystemScheduler::SystemScheduler(Scene &scene, jobs::JobSystem &jobSystem)
+    : m_scene(&scene), m_jobSystem(&jobSystem) {}
+
+System &SystemScheduler::addSystem(std::string name,
+                                   System::Function function) {
+    m_nodes.emplace_back(
+        std::make_unique<Node>(System(std::move(name), std::move(function))));
+    m_graphDirty = true;
+
+    return m_nodes.back()->system;
+}
+
+void SystemScheduler::run(const float deltaTime) {
+    if (m_nodes.empty()) {
+        return;
+    }
+
+    if (m_graphDirty) {
+        buildGraph();
+    }
+
+    if (m_hasMainThreadSystems && !m_jobSystem->isMainThread()) {
+        throw std::runtime_error(
+            "Error: Systems pinned to the main thread must be run from the "
+            "job system's main thread!\n");
+    }
+
+    m_deltaTime = deltaTime;
+    m_exception = nullptr;
+    for (const auto &node : m_nodes) {
+        node->remainingDependencies.store(node->dependencyCount,
+                                          std::memory_order_relaxed);
+    }
+
+    for (const auto &node : m_nodes) {
+        if (node->dependencyCount == 0) {
+            dispatch(*node);
+        }
+    }
+
+    m_jobSystem->wait(m_frame);
+
+    if (m_exception) {
+        for (const auto &node : m_nodes) {
+            node->commands.clear();
+        }
+
+        std::rethrow_exception(m_exception);
+    }
+
+    m_commandBuffers.clear();
+    for (const auto &node : m_nodes) {
+        m_commandBuffers.emplace_back(&node->commands);
+    }
+
+    m_scene->applyCommands(m_commandBuffers);
+
+    for (const auto &node : m_nodes) {
+        node->lastRunTick = m_scene->changeTick();
+    }
+    m_scene->advanceChangeTick();
+}
+
+void SystemScheduler::buildGraph() {
+    m_hasMainThreadSystems = false;
+    for (const auto &node : m_nodes) {
+        node->successors.clear();
+        node->dependencyCount = 0;
+        m_hasMainThreadSystems |= node->system.m_mainThread;
+    }
+
+    // Conflicting systems keep the order they were added in.
+    for (std::size_t i = 0; i < m_nodes.size(); i++) {
+        for (std::size_t j = i + 1; j < m_nodes.size(); j++) {
+            if (m_nodes[i]->system.conflictsWith(m_nodes[j]->system)) {
+                m_nodes[i]->successors.emplace_back(m_nodes[j].get());
+                m_nodes[j]->dependencyCount++;
+            }
+        }
+    }
+
+    m_graphDirty = false;
+}
+
+void SystemScheduler::dispatch(Node &node) {
+    const auto job = [this, &node] { execute(node); };
+
+    if (node.system.m_mainThread) {
+        m_jobSystem->runOnMainThread(job, &m_frame);
+    } else {
+        m_jobSystem->run(job, &m_frame);
+    }
+}
+
+void SystemScheduler::execute(Node &node) {
+    try {
+        node.system.m_function(
+            SystemContext{*m_scene, node.commands, m_deltaTime,
+                          node.lastRunTick});
+    } catch (...) {
+        std::scoped_lock lock(m_exceptionMutex);
+        if (!m_exception) {
+            m_exception = std::current_exception();
+        }
+    }
+
+    // Successors are dispatched before this job signals the frame counter,
+    // so the frame cannot be seen as finished in between.
+    for (Node *successor : node.successors) {
+        if (successor->remainingDependencies.fetch_sub(
+                1, std::memory_order_acq_rel) == 1) {
+            dispatch(*successor);
+        }
+    }
+}
+
+}  // namespace avenir::scene
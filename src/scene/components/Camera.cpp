@@ -4,10 +4,11 @@
 
 namespace avenir::scene::components {
 
-std::unique_ptr<Component> Camera::clone() const {
-    return std::make_unique<Camera>(*this);
-}
+std::string_view Camera::name() const { return staticName; }
 
-std::string Camera::name() const { return std::string(staticName); }
+glm::mat4 Camera::projectionMatrix(const float aspectRatio) const {
+    return glm::perspective(glm::radians(fov), aspectRatio, nearPlane,
+                            farPlane);
+}
 
 }  // namespace avenir::scene::components
@@ -2,10 +2,6 @@
 
 namespace avenir::scene::components {
 
-std::unique_ptr<Component> MeshRenderer::clone() const {
-    return std::make_unique<MeshRenderer>(*this);
-}
-
-std::string MeshRenderer::name() const { return std::string(staticName); }
+std::string_view MeshRenderer::name() const { return staticName; }
 
 }  // namespace avenir::scene::components
\ No newline at end of file
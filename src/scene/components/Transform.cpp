@@ -4,11 +4,187 @@
 
 #include "avenir/scene/components/Transform.hpp"
 
+#include <stdexcept>
+
 #include <glm/gtc/quaternion.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+#define AVENIR_TRANSFORM_SSE 1
+#include <immintrin.h>
+#endif
+
+#if defined(AVENIR_TRANSFORM_SSE) && (defined(__GNUC__) || defined(__clang__))
+#define AVENIR_TRANSFORM_AVX2 1
+#endif
+
 namespace avenir::scene::components {
 
+namespace {
+
+// T * R * S written out directly: the columns of the quaternion's rotation
+// matrix scaled per axis, with the position as the last column.
+glm::mat4 composeLocalMatrix(const float px, const float py, const float pz,
+                             const float qx, const float qy, const float qz,
+                             const float qw, const float sx, const float sy,
+                             const float sz) {
+    const float x2 = qx + qx, y2 = qy + qy, z2 = qz + qz;
+    const float xx = qx * x2, yy = qy * y2, zz = qz * z2;
+    const float xy = qx * y2, xz = qx * z2, yz = qy * z2;
+    const float wx = qw * x2, wy = qw * y2, wz = qw * z2;
+
+    return {glm::vec4((1.0f - (yy + zz)) * sx, (xy + wz) * sx, (xz - wy) * sx,
+                      0.0f),
+            glm::vec4((xy - wz) * sy, (1.0f - (xx + zz)) * sy, (yz + wx) * sy,
+                      0.0f),
+            glm::vec4((xz + wy) * sz, (yz - wx) * sz, (1.0f - (xx + yy)) * sz,
+                      0.0f),
+            glm::vec4(px, py, pz, 1.0f)};
+}
+
+#ifdef AVENIR_TRANSFORM_SSE
+std::size_t localMatricesSse(const TransformArrays &t, glm::mat4 *matrices,
+                             std::size_t i, const std::size_t count) {
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 zero = _mm_setzero_ps();
+
+    for (; i + 4 <= count; i += 4) {
+        const __m128 qx = _mm_loadu_ps(&t.rotationX[i]);
+        const __m128 qy = _mm_loadu_ps(&t.rotationY[i]);
+        const __m128 qz = _mm_loadu_ps(&t.rotationZ[i]);
+        const __m128 qw = _mm_loadu_ps(&t.rotationW[i]);
+        const __m128 sx = _mm_loadu_ps(&t.scaleX[i]);
+        const __m128 sy = _mm_loadu_ps(&t.scaleY[i]);
+        const __m128 sz = _mm_loadu_ps(&t.scaleZ[i]);
+
+        const __m128 x2 = _mm_add_ps(qx, qx);
+        const __m128 y2 = _mm_add_ps(qy, qy);
+        const __m128 z2 = _mm_add_ps(qz, qz);
+        const __m128 xx = _mm_mul_ps(qx, x2), yy = _mm_mul_ps(qy, y2);
+        const __m128 zz = _mm_mul_ps(qz, z2), xy = _mm_mul_ps(qx, y2);
+        const __m128 xz = _mm_mul_ps(qx, z2), yz = _mm_mul_ps(qy, z2);
+        const __m128 wx = _mm_mul_ps(qw, x2), wy = _mm_mul_ps(qw, y2);
+        const __m128 wz = _mm_mul_ps(qw, z2);
+
+        // columns[c][r] holds element (c, r) of four matrices, one per lane.
+        __m128 columns[4][4] = {
+            {_mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(yy, zz)), sx),
+             _mm_mul_ps(_mm_add_ps(xy, wz), sx),
+             _mm_mul_ps(_mm_sub_ps(xz, wy), sx), zero},
+            {_mm_mul_ps(_mm_sub_ps(xy, wz), sy),
+             _mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(xx, zz)), sy),
+             _mm_mul_ps(_mm_add_ps(yz, wx), sy), zero},
+            {_mm_mul_ps(_mm_add_ps(xz, wy), sz),
+             _mm_mul_ps(_mm_sub_ps(yz, wx), sz),
+             _mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(xx, yy)), sz), zero},
+            {_mm_loadu_ps(&t.positionX[i]), _mm_loadu_ps(&t.positionY[i]),
+             _mm_loadu_ps(&t.positionZ[i]), one}};
+
+        // Transposing each column block turns lanes back into matrices.
+        for (int column = 0; column < 4; column++) {
+            __m128 *c = columns[column];
+            _MM_TRANSPOSE4_PS(c[0], c[1], c[2], c[3]);
+            for (int lane = 0; lane < 4; lane++) {
+                _mm_storeu_ps(&matrices[i + lane][column][0], c[lane]);
+            }
+        }
+    }
+
+    return i;
+}
+#endif
+
+#ifdef AVENIR_TRANSFORM_AVX2
+__attribute__((target("avx2"))) inline void transpose8x8(__m256 (&rows)[8]) {
+    const __m256 t0 = _mm256_unpacklo_ps(rows[0], rows[1]);
+    const __m256 t1 = _mm256_unpackhi_ps(rows[0], rows[1]);
+    const __m256 t2 = _mm256_unpacklo_ps(rows[2], rows[3]);
+    const __m256 t3 = _mm256_unpackhi_ps(rows[2], rows[3]);
+    const __m256 t4 = _mm256_unpacklo_ps(rows[4], rows[5]);
+    const __m256 t5 = _mm256_unpackhi_ps(rows[4], rows[5]);
+    const __m256 t6 = _mm256_unpacklo_ps(rows[6], rows[7]);
+    const __m256 t7 = _mm256_unpackhi_ps(rows[6], rows[7]);
+
+    const __m256 u0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+    const __m256 u1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+    const __m256 u2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+    const __m256 u3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+    const __m256 u4 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(1, 0, 1, 0));
+    const __m256 u5 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(3, 2, 3, 2));
+    const __m256 u6 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(1, 0, 1, 0));
+    const __m256 u7 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(3, 2, 3, 2));
+
+    rows[0] = _mm256_permute2f128_ps(u0, u4, 0x20);
+    rows[1] = _mm256_permute2f128_ps(u1, u5, 0x20);
+    rows[2] = _mm256_permute2f128_ps(u2, u6, 0x20);
+    rows[3] = _mm256_permute2f128_ps(u3, u7, 0x20);
+    rows[4] = _mm256_permute2f128_ps(u0, u4, 0x31);
+    rows[5] = _mm256_permute2f128_ps(u1, u5, 0x31);
+    rows[6] = _mm256_permute2f128_ps(u2, u6, 0x31);
+    rows[7] = _mm256_permute2f128_ps(u3, u7, 0x31);
+}
+
+__attribute__((target("avx2"))) std::size_t localMatricesAvx2(
+    const TransformArrays &t, glm::mat4 *matrices, std::size_t i,
+    const std::size_t count) {
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 zero = _mm256_setzero_ps();
+
+    for (; i + 8 <= count; i += 8) {
+        const __m256 qx = _mm256_loadu_ps(&t.rotationX[i]);
+        const __m256 qy = _mm256_loadu_ps(&t.rotationY[i]);
+        const __m256 qz = _mm256_loadu_ps(&t.rotationZ[i]);
+        const __m256 qw = _mm256_loadu_ps(&t.rotationW[i]);
+        const __m256 sx = _mm256_loadu_ps(&t.scaleX[i]);
+        const __m256 sy = _mm256_loadu_ps(&t.scaleY[i]);
+        const __m256 sz = _mm256_loadu_ps(&t.scaleZ[i]);
+
+        const __m256 x2 = _mm256_add_ps(qx, qx);
+        const __m256 y2 = _mm256_add_ps(qy, qy);
+        const __m256 z2 = _mm256_add_ps(qz, qz);
+        const __m256 xx = _mm256_mul_ps(qx, x2), yy = _mm256_mul_ps(qy, y2);
+        const __m256 zz = _mm256_mul_ps(qz, z2), xy = _mm256_mul_ps(qx, y2);
+        const __m256 xz = _mm256_mul_ps(qx, z2), yz = _mm256_mul_ps(qy, z2);
+        const __m256 wx = _mm256_mul_ps(qw, x2), wy = _mm256_mul_ps(qw, y2);
+        const __m256 wz = _mm256_mul_ps(qw, z2);
+
+        // The first eight and last eight matrix elements (columns 0-1 and
+        // 2-3), each holding eight matrices across its lanes.
+        __m256 low[8] = {
+            _mm256_mul_ps(_mm256_sub_ps(one, _mm256_add_ps(yy, zz)), sx),
+            _mm256_mul_ps(_mm256_add_ps(xy, wz), sx),
+            _mm256_mul_ps(_mm256_sub_ps(xz, wy), sx),
+            zero,
+            _mm256_mul_ps(_mm256_sub_ps(xy, wz), sy),
+            _mm256_mul_ps(_mm256_sub_ps(one, _mm256_add_ps(xx, zz)), sy),
+            _mm256_mul_ps(_mm256_add_ps(yz, wx), sy),
+            zero};
+        __m256 high[8] = {
+            _mm256_mul_ps(_mm256_add_ps(xz, wy), sz),
+            _mm256_mul_ps(_mm256_sub_ps(yz, wx), sz),
+            _mm256_mul_ps(_mm256_sub_ps(one, _mm256_add_ps(xx, yy)), sz),
+            zero,
+            _mm256_loadu_ps(&t.positionX[i]),
+            _mm256_loadu_ps(&t.positionY[i]),
+            _mm256_loadu_ps(&t.positionZ[i]),
+            one};
+
+        transpose8x8(low);
+        transpose8x8(high);
+
+        for (int lane = 0; lane < 8; lane++) {
+            float *matrix = &matrices[i + lane][0][0];
+            _mm256_storeu_ps(matrix, low[lane]);
+            _mm256_storeu_ps(matrix + 8, high[lane]);
+        }
+    }
+
+    return i;
+}
+#endif
+
+}  // namespace
+
 Transform::Transform(const glm::vec3 position) { this->position = position; }
 
 Transform::Transform(const glm::vec3 position, const glm::quat rotation,
@@ -31,21 +207,72 @@ glm::vec3 Transform::right() const {
 }
 
 glm::mat4 Transform::localMatrix() const {
-    const glm::mat4 T = glm::translate(glm::mat4(1.0f), position);
-    const glm::mat4 R = glm::mat4_cast(rotation);
-    const glm::mat4 S = glm::scale(glm::mat4(1.0f), scale);
-
-    return T * R * S;
+    return composeLocalMatrix(position.x, position.y, position.z, rotation.x,
+                              rotation.y, rotation.z, rotation.w, scale.x,
+                              scale.y, scale.z);
 }
 
 glm::mat4 Transform::inverseLocalMatrix() const {
-    return glm::inverse(localMatrix());
+    // (T * R * S)^-1 = S^-1 * R^T * T^-1. For a unit quaternion the rotation
+    // inverts by transposing and the scale by taking reciprocals, so the
+    // upper 3x3 is R^T with row i divided by scale[i] and the translation is
+    // that block applied to -position. No general 4x4 inverse needed.
+    const glm::mat3 R = glm::mat3_cast(rotation);
+    const glm::vec3 inverseScale = 1.0f / scale;
+
+    glm::mat4 inverse(1.0f);
+    for (int column = 0; column < 3; column++) {
+        for (int row = 0; row < 3; row++) {
+            inverse[column][row] = R[row][column] * inverseScale[row];
+        }
+    }
+
+    for (int row = 0; row < 3; row++) {
+        inverse[3][row] =
+            -(inverse[0][row] * position.x + inverse[1][row] * position.y +
+              inverse[2][row] * position.z);
+    }
+
+    return inverse;
 }
 
-std::unique_ptr<Component> Transform::clone() const {
-    return std::make_unique<Transform>(*this);
+void Transform::localMatrices(const TransformArrays &transforms,
+                              const std::span<glm::mat4> matrices) {
+    const std::size_t count = matrices.size();
+    for (const std::span<const float> stream :
+         {transforms.positionX, transforms.positionY, transforms.positionZ,
+          transforms.rotationX, transforms.rotationY, transforms.rotationZ,
+          transforms.rotationW, transforms.scaleX, transforms.scaleY,
+          transforms.scaleZ}) {
+        if (stream.size() < count) {
+            throw std::runtime_error(
+                "Error: Transform streams are shorter than the output!\n");
+        }
+    }
+
+    std::size_t i = 0;
+
+#ifdef AVENIR_TRANSFORM_AVX2
+    static const bool hasAvx2 = __builtin_cpu_supports("avx2");
+    if (hasAvx2) {
+        i = localMatricesAvx2(transforms, matrices.data(), i, count);
+    }
+#endif
+
+#ifdef AVENIR_TRANSFORM_SSE
+    i = localMatricesSse(transforms, matrices.data(), i, count);
+#endif
+
+    for (; i < count; i++) {
+        matrices[i] = composeLocalMatrix(
+            transforms.positionX[i], transforms.positionY[i],
+            transforms.positionZ[i], transforms.rotationX[i],
+            transforms.rotationY[i], transforms.rotationZ[i],
+            transforms.rotationW[i], transforms.scaleX[i], transforms.scaleY[i],
+            transforms.scaleZ[i]);
+    }
 }
 
-std::string Transform::name() const { return std::string(staticName); }
+std::string_view Transform::name() const { return staticName; }
 
 }  // namespace avenir::scene::components
\ No newline at end of file
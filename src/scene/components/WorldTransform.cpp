@@ -0,0 +1,7 @@
+#include "avenir/scene/components/WorldTransform.hpp"
+
+namespace avenir::scene::components {
+
+std::string_view WorldTransform::name() const { return staticName; }
+
+}  // namespace avenir::scene::components
@@ -0,0 +1,18 @@
+#ifndef AVENIR_TESTS_CHECK_HPP
+#define AVENIR_TESTS_CHECK_HPP
+
+#include <cstdio>
+#include <cstdlib>
+
+// Aborts the test with the failing expression and its location. Unlike
+// assert() it stays active in release builds.
+#define AVENIR_CHECK(condition)                                              \
+    do {                                                                     \
+        if (!(condition)) {                                                  \
+            std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__,      \
+                         __LINE__, #condition);                              \
+            std::exit(EXIT_FAILURE);                                         \
+        }                                                                    \
+    } while (false)
+
+#endif  // AVENIR_TESTS_CHECK_HPP
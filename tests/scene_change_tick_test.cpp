@@ -0,0 +1,38 @@
+#include "Check.hpp"
+
+#include "avenir/scene/Scene.hpp"
+#include "avenir/scene/components/Transform.hpp"
+#include "avenir/scene/components/WorldTransform.hpp"
+
+using namespace avenir::scene;
+
+namespace {
+
+// Reading a cached world matrix must not count as writing WorldTransform.
+void worldMatrixReadsDoNotStampChanges() {
+    Scene scene;
+    Entity parent = scene.createEntity();
+    Entity child = scene.createEntity();
+    scene.setEntityParent(child.id(), parent.id());
+    parent.component<components::Transform>().position = glm::vec3(1.0f);
+
+    scene.updateWorldTransforms();
+    scene.advanceChangeTick();
+    AVENIR_CHECK(scene.count<Changed<components::WorldTransform>>() == 0);
+
+    (void)scene.entityWorldMatrix(child.id());
+    (void)scene.entityInverseWorldMatrix(parent.id());
+    AVENIR_CHECK(scene.count<Changed<components::WorldTransform>>() == 0);
+
+    // A real update is still reported.
+    parent.component<components::Transform>().position = glm::vec3(2.0f);
+    (void)scene.entityWorldMatrix(child.id());
+    AVENIR_CHECK(scene.count<Changed<components::WorldTransform>>() == 2);
+}
+
+}  // namespace
+
+int main() {
+    worldMatrixReadsDoNotStampChanges();
+    return 0;
+}
@@ -0,0 +1,76 @@
+#include "Check.hpp"
+
+#include <optional>
+#include <stdexcept>
+
+#include "avenir/scene/Scene.hpp"
+#include "avenir/scene/SceneCommandBuffer.hpp"
+#include "avenir/scene/components/Camera.hpp"
+
+using namespace avenir::scene;
+
+namespace {
+
+// Self-parenting is caught while recording, for existing and pending
+// entities alike, and leaves nothing in the buffer.
+void selfParentIsRejectedOnRecord() {
+    Scene scene;
+    const EntityId entity = scene.createEntity().id();
+
+    SceneCommandBuffer commands;
+    const SceneCommandBuffer::PendingEntity pending = commands.createEntity();
+
+    bool threw = false;
+    try {
+        commands.setEntityParent(entity, entity);
+    } catch (const std::runtime_error &) {
+        threw = true;
+    }
+    AVENIR_CHECK(threw);
+
+    threw = false;
+    try {
+        commands.setEntityParent(pending, pending);
+    } catch (const std::runtime_error &) {
+        threw = true;
+    }
+    AVENIR_CHECK(threw);
+
+    // A pending entity and an existing one may share an index.
+    commands.setEntityParent(pending, entity);
+    scene.applyCommands(commands);
+    AVENIR_CHECK(scene.entityParent(commands.entity(pending)) ==
+                 std::optional(entity));
+}
+
+// A reparent that would close a loop is dropped; the rest of the batch,
+// including commands that run before it, still applies and the buffer is
+// left empty.
+void cyclicReparentIsDroppedOnApply() {
+    Scene scene;
+    const EntityId root = scene.createEntity().id();
+    const EntityId leaf = scene.createEntity().id();
+    scene.setEntityParent(leaf, root);
+
+    SceneCommandBuffer commands;
+    commands.addComponent<components::Camera>(leaf);
+    commands.setEntityParent(root, leaf);
+    scene.applyCommands(commands);
+
+    AVENIR_CHECK(commands.empty());
+    AVENIR_CHECK(scene.hasComponent<components::Camera>(leaf));
+    AVENIR_CHECK(!scene.entityParent(root));
+    AVENIR_CHECK(scene.entityParent(leaf) == std::optional(root));
+
+    // Applying the cleared buffer again is a no-op.
+    scene.applyCommands(commands);
+    AVENIR_CHECK(scene.hasComponent<components::Camera>(leaf));
+}
+
+}  // namespace
+
+int main() {
+    selfParentIsRejectedOnRecord();
+    cyclicReparentIsDroppedOnApply();
+    return 0;
+}
@@ -0,0 +1,56 @@
+#include "Check.hpp"
+
+#include <optional>
+#include <stdexcept>
+
+#include "avenir/scene/Scene.hpp"
+
+using namespace avenir::scene;
+
+namespace {
+
+bool throwsOnReparent(Scene &scene, const EntityId child,
+                      const EntityId parent) {
+    try {
+        scene.setEntityParent(child, parent);
+    } catch (const std::runtime_error &) {
+        return true;
+    }
+
+    return false;
+}
+
+// Parenting an entity under itself or any of its descendants would form a
+// cycle, so it must throw and leave the hierarchy as it was.
+void reparentingUnderDescendantThrows() {
+    Scene scene;
+    const EntityId root = scene.createEntity().id();
+    const EntityId middle = scene.createEntity().id();
+    const EntityId leaf = scene.createEntity().id();
+    const EntityId other = scene.createEntity().id();
+    scene.setEntityParent(middle, root);
+    scene.setEntityParent(leaf, middle);
+
+    AVENIR_CHECK(throwsOnReparent(scene, root, root));
+    AVENIR_CHECK(throwsOnReparent(scene, root, middle));
+    AVENIR_CHECK(throwsOnReparent(scene, root, leaf));
+    AVENIR_CHECK(throwsOnReparent(scene, middle, leaf));
+
+    AVENIR_CHECK(!scene.entityParent(root));
+    AVENIR_CHECK(scene.entityParent(middle) == std::optional(root));
+    AVENIR_CHECK(scene.entityParent(leaf) == std::optional(middle));
+    (void)scene.entityWorldMatrix(leaf);
+
+    // Moves that do not close a loop are still allowed.
+    AVENIR_CHECK(!throwsOnReparent(scene, leaf, root));
+    AVENIR_CHECK(!throwsOnReparent(scene, middle, other));
+    AVENIR_CHECK(!throwsOnReparent(scene, root, middle));
+    AVENIR_CHECK(scene.entityParent(root) == std::optional(middle));
+}
+
+}  // namespace
+
+int main() {
+    reparentingUnderDescendantThrows();
+    return 0;
+}
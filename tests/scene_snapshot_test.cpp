@@ -0,0 +1,50 @@
+#include "Check.hpp"
+
+#include <utility>
+
+#include "avenir/scene/Scene.hpp"
+#include "avenir/scene/SceneSnapshot.hpp"
+#include "avenir/scene/components/Transform.hpp"
+#include "avenir/scene/components/WorldTransform.hpp"
+
+using namespace avenir::scene;
+
+namespace {
+
+// Reads after a capture must leave the chunks shared with the snapshot;
+// only a write may copy one.
+void readsDoNotUnshareChunks() {
+    Scene scene;
+    Entity entity = scene.createEntity();
+    entity.component<components::Transform>().position = glm::vec3(3.0f);
+
+    SceneSnapshot snapshot;
+    scene.captureSnapshot(snapshot);
+    const std::size_t blocksInUse = scene.allocationStats().blocksInUse;
+
+    const Entity &constEntity = entity;
+    AVENIR_CHECK(constEntity.component<components::Transform>().position.x ==
+                 3.0f);
+    (void)std::as_const(scene).component<components::WorldTransform>(
+        entity.id());
+    (void)scene.entityWorldMatrix(entity.id());
+    (void)scene.entityInverseWorldMatrix(entity.id());
+    AVENIR_CHECK(scene.allocationStats().blocksInUse == blocksInUse);
+
+    // The first write copies the chunk; the snapshot keeps the old value.
+    entity.component<components::Transform>().position = glm::vec3(4.0f);
+    AVENIR_CHECK(scene.allocationStats().blocksInUse == blocksInUse + 1);
+    AVENIR_CHECK(snapshot.component<components::Transform>(entity.id())
+                     .position.x == 3.0f);
+    AVENIR_CHECK(constEntity.component<components::Transform>().position.x ==
+                 4.0f);
+
+    snapshot.reset();
+}
+
+}  // namespace
+
+int main() {
+    readsDoNotUnshareChunks();
+    return 0;
+}
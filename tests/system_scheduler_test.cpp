@@ -0,0 +1,110 @@
+#include "Check.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <thread>
+
+#include "avenir/jobs/JobSystem.hpp"
+#include "avenir/scene/Scene.hpp"
+#include "avenir/scene/SystemScheduler.hpp"
+#include "avenir/scene/components/Camera.hpp"
+#include "avenir/scene/components/MeshRenderer.hpp"
+#include "avenir/scene/components/Transform.hpp"
+#include "avenir/scene/components/WorldTransform.hpp"
+
+using namespace avenir;
+using namespace avenir::scene;
+
+namespace {
+
+constexpr std::size_t kEntityCount = 256;
+constexpr std::size_t kSystemCount = 4;
+constexpr int kRounds = 200;
+
+// Holds each system until all of them have started, or a moment has passed,
+// so that their first queries overlap.
+void rendezvous(std::atomic<std::size_t> &started) {
+    started++;
+    const auto deadline =
+        std::chrono::steady_clock::now() + std::chrono::milliseconds(50);
+    while (started < kSystemCount &&
+           std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::yield();
+    }
+}
+
+// Read-only systems run concurrently, and each one's first query builds the
+// cache for a different mask. Building and looking up caches must not race.
+void concurrentSystemsQueryDifferentMasks(jobs::JobSystem &jobSystem) {
+    Scene scene;
+    for (std::size_t i = 0; i < kEntityCount; i++) {
+        Entity entity = scene.createEntity();
+        if (i % 2 == 0) {
+            entity.addComponent<components::Camera>();
+        }
+        if (i % 4 == 0) {
+            entity.addComponent<components::MeshRenderer>();
+        }
+    }
+
+    std::atomic<std::size_t> started = 0;
+    std::atomic<std::size_t> transforms = 0;
+    std::atomic<std::size_t> cameras = 0;
+    std::atomic<std::size_t> meshRenderers = 0;
+    std::atomic<std::size_t> both = 0;
+
+    SystemScheduler scheduler(scene, jobSystem);
+    scheduler
+        .addSystem("transforms",
+                   [&](const SystemContext &context) {
+                       rendezvous(started);
+                       transforms += context.scene.count<
+                           const components::Transform>();
+                   })
+        .reads<components::Transform>();
+    scheduler
+        .addSystem("cameras",
+                   [&](const SystemContext &context) {
+                       rendezvous(started);
+                       cameras +=
+                           context.scene.count<const components::Camera>();
+                   })
+        .reads<components::Camera>();
+    scheduler
+        .addSystem("meshRenderers",
+                   [&](const SystemContext &context) {
+                       rendezvous(started);
+                       meshRenderers += context.scene.count<
+                           const components::MeshRenderer>();
+                   })
+        .reads<components::MeshRenderer>();
+    scheduler
+        .addSystem("both",
+                   [&](const SystemContext &context) {
+                       rendezvous(started);
+                       context.scene.each<const components::Camera,
+                                          const components::MeshRenderer>(
+                           [&](const components::Camera &,
+                               const components::MeshRenderer &) { both++; });
+                   })
+        .reads<components::Camera, components::MeshRenderer>();
+
+    scheduler.run(0.0f);
+
+    AVENIR_CHECK(transforms == kEntityCount);
+    AVENIR_CHECK(cameras == kEntityCount / 2);
+    AVENIR_CHECK(meshRenderers == kEntityCount / 4);
+    AVENIR_CHECK(both == kEntityCount / 4);
+}
+
+}  // namespace
+
+int main() {
+    jobs::JobSystem jobSystem(4);
+    for (int round = 0; round < kRounds; round++) {
+        concurrentSystemsQueryDifferentMasks(jobSystem);
+    }
+
+    return 0;
+}
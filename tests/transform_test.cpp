@@ -0,0 +1,189 @@
+#include "Check.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include "avenir/jobs/JobSystem.hpp"
+#include "avenir/scene/Scene.hpp"
+#include "avenir/scene/components/Transform.hpp"
+#include "avenir/scene/components/WorldTransform.hpp"
+
+using namespace avenir;
+using namespace avenir::scene;
+
+namespace {
+
+components::Transform randomTransform(std::mt19937 &random) {
+    std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+    std::uniform_real_distribution<float> axis(-1.0f, 1.0f);
+    std::uniform_real_distribution<float> angle(-3.14159f, 3.14159f);
+    // Non-uniform, never close to zero.
+    std::uniform_real_distribution<float> scale(0.1f, 10.0f);
+
+    glm::vec3 rotationAxis(axis(random), axis(random), axis(random));
+    if (glm::length(rotationAxis) < 1e-3f) {
+        rotationAxis = glm::vec3(0.0f, 1.0f, 0.0f);
+    }
+
+    return {glm::vec3(position(random), position(random), position(random)),
+            glm::angleAxis(angle(random), glm::normalize(rotationAxis)),
+            glm::vec3(scale(random), scale(random), scale(random))};
+}
+
+glm::mat4 glmLocalMatrix(const components::Transform &transform) {
+    return glm::translate(glm::mat4(1.0f), transform.position) *
+           glm::mat4_cast(transform.rotation) *
+           glm::scale(glm::mat4(1.0f), transform.scale);
+}
+
+float maxError(const glm::mat4 &a, const glm::mat4 &b) {
+    float error = 0.0f;
+    for (int column = 0; column < 4; column++) {
+        for (int row = 0; row < 4; row++) {
+            error = std::max(error, std::fabs(a[column][row] - b[column][row]));
+        }
+    }
+
+    return error;
+}
+
+// The closed-form inverse must match a general 4x4 inverse to within float
+// rounding, relative to the matrix's largest element, for arbitrary rotations
+// and non-uniform scales.
+void inverseLocalMatrixMatchesGeneralInverse() {
+    std::mt19937 random(3);
+    constexpr int kSamples = 100000;
+    constexpr float kTolerance = 5e-5f;
+
+    float worstError = 0.0f;
+    for (int i = 0; i < kSamples; i++) {
+        const components::Transform transform = randomTransform(random);
+        const glm::mat4 inverse = transform.inverseLocalMatrix();
+        const glm::mat4 expected = glm::inverse(glmLocalMatrix(transform));
+
+        float magnitude = 1.0f;
+        for (int column = 0; column < 4; column++) {
+            for (int row = 0; row < 4; row++) {
+                magnitude =
+                    std::max(magnitude, std::fabs(expected[column][row]));
+            }
+        }
+
+        worstError = std::max(worstError,
+                              maxError(inverse, expected) / magnitude);
+    }
+
+    AVENIR_CHECK(worstError < kTolerance);
+}
+
+// The batched kernels must agree with localMatrix() on every lane, including
+// a remainder that takes the scalar loop.
+void batchedLocalMatricesMatchScalar() {
+    std::mt19937 random(1);
+    constexpr std::size_t kCount = 1003;
+
+    std::vector<components::Transform> transforms;
+    std::vector<float> streams[10];
+    for (std::size_t i = 0; i < kCount; i++) {
+        const components::Transform &t =
+            transforms.emplace_back(randomTransform(random));
+        const float values[10] = {t.position.x, t.position.y, t.position.z,
+                                  t.rotation.x, t.rotation.y, t.rotation.z,
+                                  t.rotation.w, t.scale.x,    t.scale.y,
+                                  t.scale.z};
+        for (int stream = 0; stream < 10; stream++) {
+            streams[stream].emplace_back(values[stream]);
+        }
+    }
+
+    std::vector<glm::mat4> matrices(kCount);
+    components::Transform::localMatrices(
+        {streams[0], streams[1], streams[2], streams[3], streams[4],
+         streams[5], streams[6], streams[7], streams[8], streams[9]},
+        matrices);
+
+    for (std::size_t i = 0; i < kCount; i++) {
+        AVENIR_CHECK(maxError(matrices[i], transforms[i].localMatrix()) <
+                     1e-5f);
+        AVENIR_CHECK(maxError(matrices[i], glmLocalMatrix(transforms[i])) <
+                     1e-3f);
+    }
+}
+
+// Large enough to take the threaded, chunk-batched path, with workers even
+// on a single-core machine. Each world matrix must equal the product of its
+// ancestors' local matrices, before and after a subtree is moved.
+void worldTransformsMatchHierarchy() {
+    std::mt19937 random(2);
+    constexpr std::size_t kCount = 20000;
+
+    jobs::JobSystem jobSystem(3);
+    Scene scene(jobSystem);
+    std::vector<EntityId> ids;
+    for (std::size_t i = 0; i < kCount; i++) {
+        Entity entity = scene.createEntity();
+        components::Transform transform = randomTransform(random);
+        transform.scale = glm::vec3(1.0f);
+        entity.component<components::Transform>() = transform;
+        if (i >= 8) {
+            scene.setEntityParent(entity.id(), ids[i / 8 - 1]);
+        }
+        ids.emplace_back(entity.id());
+    }
+
+    const auto expected = [&](EntityId id) {
+        glm::mat4 matrix = std::as_const(scene)
+                               .component<components::Transform>(id)
+                               .localMatrix();
+        while (const std::optional<EntityId> parent = scene.entityParent(id)) {
+            matrix = std::as_const(scene)
+                         .component<components::Transform>(*parent)
+                         .localMatrix() *
+                     matrix;
+            id = *parent;
+        }
+
+        return matrix;
+    };
+
+    const auto check = [&] {
+        for (std::size_t i = 0; i < kCount; i += 7) {
+            AVENIR_CHECK(maxError(scene.entityWorldMatrix(ids[i]),
+                                  expected(ids[i])) < 1e-2f);
+        }
+    };
+
+    check();
+    scene.component<components::Transform>(ids[3]).position.x += 5.0f;
+    check();
+
+    // Small dirty subtrees, one nested in another, are rebuilt by walking
+    // just those subtrees.
+    scene.component<components::Transform>(ids[100]).position.y -= 3.0f;
+    scene.component<components::Transform>(ids[808]).rotation =
+        glm::angleAxis(0.5f, glm::vec3(0.0f, 0.0f, 1.0f));
+    scene.component<components::Transform>(ids[kCount - 1]).position.z += 1.0f;
+    scene.setEntityParent(ids[kCount - 2], ids[5]);
+    const std::size_t moved[] = {100, 808, 812, 6475, kCount - 2, kCount - 1};
+    for (const std::size_t i : moved) {
+        AVENIR_CHECK(maxError(scene.entityWorldMatrix(ids[i]),
+                              expected(ids[i])) < 1e-2f);
+    }
+    check();
+}
+
+}  // namespace
+
+int main() {
+    inverseLocalMatrixMatchesGeneralInverse();
+    batchedLocalMatricesMatchScalar();
+    worldTransformsMatchHierarchy();
+    return 0;
+}